@@ -50,4 +50,43 @@ vector<T> BucketMap<T>::getElements(Rectangle area) const {
   return ret;
 }
 
+template<class T>
+vector<T> BucketMap<T>::getElementsInRing(Vec2 v, int ring) const {
+  vector<T> ret;
+  Vec2 center = v / bucketSize;
+  Rectangle bounds = buckets.getBounds();
+  auto addBucket = [&] (Vec2 b) {
+    if (b.inRectangle(bounds))
+      for (T elem : buckets[b])
+        ret.push_back(elem);
+  };
+  if (ring == 0)
+    addBucket(center);
+  else
+    for (int i : Range(-ring, ring + 1)) {
+      addBucket(center + Vec2(i, -ring));
+      addBucket(center + Vec2(i, ring));
+      if (i > -ring && i < ring) {
+        addBucket(center + Vec2(-ring, i));
+        addBucket(center + Vec2(ring, i));
+      }
+    }
+  return ret;
+}
+
+template<class T>
+int BucketMap<T>::getMinDistance(int ring) const {
+  return max(0, (ring - 1) * bucketSize + 1);
+}
+
+template<class T>
+int BucketMap<T>::getMaxRing(Vec2 v) const {
+  Vec2 center = v / bucketSize;
+  Rectangle bounds = buckets.getBounds();
+  return max(max(center.x - bounds.left(), bounds.right() - 1 - center.x),
+      max(center.y - bounds.top(), bounds.bottom() - 1 - center.y));
+}
+
 template class BucketMap<Creature*>;
+template class BucketMap<Task*>;
+template class BucketMap<Vec2>;
@@ -1,4 +1,5 @@
 #ifndef _BUCKET_MAP_H
+#define _BUCKET_MAP_H
 
 #include "util.h"
 
@@ -13,14 +14,27 @@ class BucketMap {
 
   vector<T> getElements(Rectangle area) const;
 
+  // Returns elements from buckets exactly 'ring' buckets away (in the dist8 metric) from the bucket
+  // containing v. No element from ring r is closer to v than getMinDistance(r).
+  vector<T> getElementsInRing(Vec2 v, int ring) const;
+  int getMinDistance(int ring) const;
+  int getMaxRing(Vec2 v) const;
+
   SERIALIZATION_DECL(BucketMap);
 
   private:
   int SERIAL(bucketSize);
-  Table<unordered_set<T>> SERIAL(buckets);
+  Table<unordered_set<T, CustomHash<T>>> SERIAL(buckets);
 };
 
 class Creature;
+class Task;
+
+class TaskBucketMap : public BucketMap<Task*> {
+  public:
+  using BucketMap::BucketMap;
+};
+
 class CreatureBucketMap : public BucketMap<Creature*> {
   public:
   using BucketMap::BucketMap;
@@ -389,36 +389,36 @@ void Collective::setRandomTask(const Creature* c) {
     setMinionTask(c, Random.choose(goodTasks));
 }
 
+const static double maxExploreDistDiff = 0.3;
+
 static bool betterPos(Position from, Position current, Position candidate) {
-  double maxDiff = 0.3;
   double curDist = from.dist8(current);
   double newDist = from.dist8(candidate);
-  return Random.getDouble() <= 1.0 - (newDist - curDist) / (curDist * maxDiff);
+  return Random.getDouble() <= 1.0 - (newDist - curDist) / (curDist * maxExploreDistDiff);
 }
 
-static optional<Position> getRandomCloseTile(Position from, const vector<Position>& tiles,
-    function<bool(Position)> predicate) {
+static optional<Position> getRandomCloseTile(Position from, const vector<Position>& tiles) {
   optional<Position> ret;
   for (Position pos : tiles)
-    if (predicate(pos) && (!ret || betterPos(from, *ret, pos)))
+    if (!ret || betterPos(from, *ret, pos))
       ret = pos;
   return ret;
 }
 
 optional<Position> Collective::getTileToExplore(const Creature* c, MinionTask task) const {
-  vector<Position> border = Random.permutation(knownTiles->getBorderTiles());
+  auto getCandidates = [this, c] (bool covered) {
+    return Random.permutation(knownTiles->getCloseBorderTiles(c->getPosition(), level, maxExploreDistDiff,
+        [this, c, covered](Position pos) {
+            return pos.isCovered() == covered &&
+                (!c->getPosition().isSameLevel(level) || c->isSameSector(pos));}));
+  };
   switch (task) {
     case MinionTask::EXPLORE_CAVES:
-      if (auto pos = getRandomCloseTile(c->getPosition(), border,
-            [this, c](Position p) {
-                return p.isSameLevel(level) && p.isCovered() &&
-                    (!c->getPosition().isSameLevel(level) || c->isSameSector(p));}))
+      if (auto pos = getRandomCloseTile(c->getPosition(), getCandidates(true)))
         return pos;
     case MinionTask::EXPLORE:
     case MinionTask::EXPLORE_NOCTURNAL:
-      return getRandomCloseTile(c->getPosition(), border,
-          [this, c](Position pos) { return pos.isSameLevel(level) && !pos.isCovered()
-              && (!c->getPosition().isSameLevel(level) || c->isSameSector(pos));});
+      return getRandomCloseTile(c->getPosition(), getCandidates(false));
     default: FAIL << "Unrecognized explore task: " << int(task);
   }
   return none;
@@ -651,10 +651,12 @@ void Collective::setControl(PCollectiveControl c) {
 
 vector<Position> Collective::getEnemyPositions() const {
   vector<Position> enemyPos;
-  for (Position pos : territory->getExtended(10))
-    if (const Creature* c = pos.getCreature())
-      if (getTribe()->isEnemy(c))
-        enemyPos.push_back(pos);
+  // Ask the level's bucket map for creatures around the territory rather than scanning every square,
+  // so the cost depends on the number of creatures nearby, not on the size of the territory.
+  if (auto bounds = territory->getExtendedBounds(10))
+    for (const Creature* c : getLevel()->getAllCreatures(*bounds))
+      if (getTribe()->isEnemy(c) && territory->isInExtended(c->getPosition(), 10))
+        enemyPos.push_back(c->getPosition());
   return enemyPos;
 }
 
@@ -1755,30 +1757,25 @@ void Collective::updateConstructions() {
           Task::buildTorch(this, elem.first, elem.second.getAttachmentDir()), elem.first)->getUniqueId());
 }
 
-void Collective::delayDangerousTasks(const vector<Position>& enemyPos1, double delayTime) {
-  vector<Vec2> enemyPos = transform2<Vec2>(filter(enemyPos1,
-        [=] (const Position& p) { return p.isSameLevel(level); }),
-      [] (const Position& p) { return p.getCoord();});
-  int infinity = 1000000;
+void Collective::delayDangerousTasks(const vector<Position>& enemyPos, double delayTime) {
+  // Breadth-first search from each intruder, using delayedPos itself as the visited set, so no table
+  // is allocated and the work is proportional to the number of intruders.
   int radius = 10;
-  Table<int> dist(Rectangle::boundingBox(enemyPos)
-      .minusMargin(-radius)
-      .intersection(getLevel()->getBounds()), infinity);
-  queue<Vec2> q;
-  for (Vec2 v : enemyPos) {
-    dist[v] = 0;
-    q.push(v);
-  }
-  while (!q.empty()) {
-    Vec2 pos = q.front();
-    q.pop();
-    delayedPos[Position(pos, level)] = delayTime;
-    if (dist[pos] >= radius)
+  vector<pair<Position, int>> q;
+  for (Position pos : enemyPos)
+    if (pos.isSameLevel(level) && (!delayedPos.count(pos) || delayedPos.at(pos) != delayTime)) {
+      delayedPos[pos] = delayTime;
+      q.push_back(make_pair(pos, 0));
+    }
+  for (int i = 0; i < q.size(); ++i) {
+    Position pos = q[i].first;
+    int dist = q[i].second;
+    if (dist >= radius)
       continue;
-    for (Vec2 v : pos.neighbors8())
-      if (v.inRectangle(dist.getBounds()) && dist[v] == infinity && territory->contains(Position(v, level))) {
-        dist[v] = dist[pos] + 1;
-        q.push(v);
+    for (Position v : pos.neighbors8())
+      if (territory->contains(v) && (!delayedPos.count(v) || delayedPos.at(v) != delayTime)) {
+        delayedPos[v] = delayTime;
+        q.push_back(make_pair(v, dist + 1));
       }
   }
 }
@@ -161,10 +161,12 @@ CreatureAction Creature::castSpell(Spell* spell, Vec2 dir) const {
 
 void Creature::addCreatureVision(CreatureVision* creatureVision) {
   creatureVisions.push_back(creatureVision);
+  onVisibilityChanged();
 }
 
 void Creature::removeCreatureVision(CreatureVision* vision) {
   removeElement(creatureVisions, vision);
+  onVisibilityChanged();
 }
 
 void Creature::pushController(PController ctrl) {
@@ -226,7 +228,10 @@ void Creature::spendTime(double t) {
   localTime += 100.0 * t / (double) getAttr(AttrType::SPEED);
   if (m)
     m->afterUpdateTime(this);
-  hidden = false;
+  if (hidden) {
+    hidden = false;
+    onVisibilityChanged();
+  }
 }
 
 CreatureAction Creature::forceMove(Vec2 dir) const {
@@ -397,7 +402,10 @@ CreatureAction Creature::wait() const {
     Debug() << getName().the() << " waiting";
     bool keepHiding = hidden;
     self->spendTime(1);
-    self->hidden = keepHiding;
+    if (keepHiding) {
+      self->hidden = true;
+      self->onVisibilityChanged();
+    }
   });
 }
 
@@ -659,6 +667,7 @@ CreatureAction Creature::hide() const {
       }
     self->spendTime(1);
     self->hidden = true;
+    self->onVisibilityChanged();
   });
 }
 
@@ -693,9 +702,16 @@ bool Creature::knowsHiding(const Creature* c) const {
   return knownHiding.contains(c);
 }
 
+void Creature::onVisibilityChanged() {
+  if (Level* level = getLevel())
+    level->updateCreatureVisibility(this);
+}
+
 void Creature::addEffect(LastingEffect effect, double time, bool msg) {
-  if (LastingEffects::affects(this, effect) && attributes->considerAffecting(effect, getGlobalTime(), time))
+  if (LastingEffects::affects(this, effect) && attributes->considerAffecting(effect, getGlobalTime(), time)) {
     LastingEffects::onAffected(this, effect, msg);
+    onVisibilityChanged();
+  }
 }
 
 void Creature::removeEffect(LastingEffect effect, bool msg) {
@@ -704,18 +720,21 @@ void Creature::removeEffect(LastingEffect effect, bool msg) {
   attributes->clearLastingEffect(effect);
   if (!isAffected(effect))
     LastingEffects::onRemoved(this, effect, msg);
+  onVisibilityChanged();
 }
 
 void Creature::addPermanentEffect(LastingEffect effect, bool msg) {
   if (!isAffected(effect))
     LastingEffects::onAffected(this, effect, msg);
   attributes->addPermanentEffect(effect);
+  onVisibilityChanged();
 }
 
 void Creature::removePermanentEffect(LastingEffect effect, bool msg) {
   attributes->removePermanentEffect(effect);
   if (!isAffected(effect))
     LastingEffects::onRemoved(this, effect, msg);
+  onVisibilityChanged();
 }
 
 bool Creature::isAffected(LastingEffect effect) const {
@@ -842,6 +861,7 @@ TribeId Creature::getTribeId() const {
 
 void Creature::setTribe(TribeId t) {
   tribe = t;
+  Tribe::onRelationsChanged();
 }
 
 bool Creature::isFriend(const Creature* c) const {
@@ -1061,8 +1081,10 @@ bool Creature::takeDamage(const Attack& attack) {
   AttackType attackType = attack.getType();
   int defense = getModifier(ModifierType::DEFENSE);
   if (Creature* attacker = attack.getAttacker()) {
-    if (attacker->tribe != tribe || Random.roll(3))
+    if ((attacker->tribe != tribe || Random.roll(3)) && !privateEnemies.contains(attacker)) {
       privateEnemies.insert(attacker);
+      Tribe::onRelationsChanged();
+    }
     if (!attacker->getAttributes().getSkills().hasDiscrete(SkillId::STEALTH))
       for (Position p : visibleCreatures)
         if (p.dist8(position) < 10 && p.getCreature() && !p.getCreature()->isDead())
@@ -1756,12 +1778,18 @@ bool Creature::isUnknownAttacker(const Creature* c) const {
 }
 
 void Creature::updateVision() {
+  VisionId newVision;
   if (attributes->getSkills().hasDiscrete(SkillId::NIGHT_VISION))
-    vision = VisionId::NIGHT;
+    newVision = VisionId::NIGHT;
   else if (attributes->getSkills().hasDiscrete(SkillId::ELF_VISION) || isAffected(LastingEffect::FLYING))
-    vision = VisionId::ELF;
+    newVision = VisionId::ELF;
   else
-    vision = VisionId::NORMAL; 
+    newVision = VisionId::NORMAL; 
+  // Called from the constructor before vision is set, when the creature isn't on a level yet.
+  bool changed = getLevel() && newVision != vision;
+  vision = newVision;
+  if (changed)
+    onVisibilityChanged();
 }
 
 VisionId Creature::getVision() const {
@@ -1769,15 +1797,21 @@ VisionId Creature::getVision() const {
 }
 
 void Creature::updateVisibleCreatures() {
-  int range = FieldOfView::sightRange;
   visibleEnemies.clear();
   visibleCreatures.clear();
-  for (Creature* c : position.getAllCreatures(range)) 
-    if (canSee(c) || isUnknownAttacker(c)) {
-      visibleCreatures.push_back(c->getPosition());
-      if (isEnemy(c))
-        visibleEnemies.push_back(c->getPosition());
-    }
+  const Level::VisibleCreatures& visible = getLevel()->getVisibleCreatures(this);
+  for (Creature* c : visible.creatures)
+    visibleCreatures.push_back(c->getPosition());
+  for (Creature* c : visible.enemies)
+    visibleEnemies.push_back(c->getPosition());
+  // Attackers are added to unknownAttackers during the turn, so they aren't part of the level's cached result.
+  if (!unknownAttackers.empty())
+    for (Creature* c : position.getAllCreatures(FieldOfView::sightRange))
+      if (isUnknownAttacker(c) && !contains(visible.creatures, c)) {
+        visibleCreatures.push_back(c->getPosition());
+        if (isEnemy(c))
+          visibleEnemies.push_back(c->getPosition());
+      }
 }
 
 vector<Creature*> Creature::getVisibleEnemies() const {
@@ -303,6 +303,7 @@ class Creature : public Renderable, public UniqueEntity<Creature> {
   vector<Position> visibleCreatures;
   VisionId SERIAL(vision);
   void updateVision();
+  void onVisibilityChanged();
   vector<string> SERIAL(personalEvents);
   bool forceMovement = false;
   optional<double> SERIAL(lastCombatTime);
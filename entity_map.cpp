@@ -55,38 +55,61 @@ int EntityMap<Key, Value>::getSize() const {
   return elems.size();
 }
 
+template <typename Key, typename Value>
+typename EntityMap<Key, Value>::MutIter EntityMap<Key, Value>::find(typename UniqueEntity<Key>::Id id) {
+  return std::lower_bound(elems.begin(), elems.end(), id,
+      [](const pair<typename UniqueEntity<Key>::Id, Value>& elem, typename UniqueEntity<Key>::Id id) {
+        return elem.first < id; });
+}
+
+template <typename Key, typename Value>
+typename EntityMap<Key, Value>::Iter EntityMap<Key, Value>::find(typename UniqueEntity<Key>::Id id) const {
+  return std::lower_bound(elems.begin(), elems.end(), id,
+      [](const pair<typename UniqueEntity<Key>::Id, Value>& elem, typename UniqueEntity<Key>::Id id) {
+        return elem.first < id; });
+}
+
 template <typename Key, typename Value>
 void EntityMap<Key, Value>::set(typename UniqueEntity<Key>::Id id, const Value& value) {
-  elems[id] = value;
+  getOrInit(id) = value;
 }
 
 template <typename Key, typename Value>
 void EntityMap<Key, Value>::erase(typename UniqueEntity<Key>::Id id) {
-  elems.erase(id);
+  auto it = find(id);
+  if (it != elems.end() && it->first == id)
+    elems.erase(it);
 }
 
 template <typename Key, typename Value>
 const Value& EntityMap<Key, Value>::getOrFail(typename UniqueEntity<Key>::Id id) const {
-  return elems.at(id);
+  auto it = find(id);
+  CHECK(it != elems.end() && it->first == id) << "Entity not found";
+  return it->second;
 }
 
 template <typename Key, typename Value>
 Value& EntityMap<Key, Value>::getOrFail(typename UniqueEntity<Key>::Id id) {
-  return elems.at(id);
+  auto it = find(id);
+  CHECK(it != elems.end() && it->first == id) << "Entity not found";
+  return it->second;
 }
 
 template <typename Key, typename Value>
 Value& EntityMap<Key, Value>::getOrInit(typename UniqueEntity<Key>::Id id) {
-  return elems[id];
+  auto it = find(id);
+  if (it == elems.end() || it->first != id)
+    it = elems.insert(it, make_pair(id, Value()));
+  return it->second;
 }
 
 template <typename Key, typename Value>
 optional<Value> EntityMap<Key, Value>::getMaybe(typename UniqueEntity<Key>::Id id) const {
-  try {
-    return getOrFail(id);
-  } catch (std::out_of_range) {
+  auto it = find(id);
+  if (it != elems.end() && it->first == id)
+    return it->second;
+  else
     return none;
-  }
 }
 
 template <typename Key, typename Value>
@@ -99,14 +122,18 @@ typename EntityMap<Key, Value>::Iter EntityMap<Key, Value>::end() const {
   return elems.end();
 }
 
-
 template <typename Key, typename Value>
 template <class Archive> 
 void EntityMap<Key, Value>::serialize(Archive& ar, const unsigned int version) {
-  serializeAll(ar, elems);
+  // Saved as a std::map to stay compatible with older saves.
+  map<typename UniqueEntity<Key>::Id, Value> asMap;
+  if (!Archive::is_loading::value)
+    asMap.insert(elems.begin(), elems.end());
+  ar & boost::serialization::make_nvp("elems", asMap);
+  if (Archive::is_loading::value)
+    elems.assign(asMap.begin(), asMap.end());
 }
 
-
 SERIALIZABLE_TMPL(EntityMap, Creature, double);
 SERIALIZABLE_TMPL(EntityMap, Creature, int);
 SERIALIZABLE_TMPL(EntityMap, Creature, Collective::CurrentTaskInfo);
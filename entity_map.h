@@ -44,13 +44,17 @@ class EntityMap {
   template <class Archive> 
   void serialize(Archive& ar, const unsigned int version);
 
-  typedef typename map<typename UniqueEntity<Key>::Id, Value>::const_iterator Iter;
+  typedef typename vector<pair<typename UniqueEntity<Key>::Id, Value>>::const_iterator Iter;
 
   Iter begin() const;
   Iter end() const;
 
   private:
-  map<typename UniqueEntity<Key>::Id, Value> SERIAL(elems);
+  // Kept sorted by id, so iteration order is the same as it would be for a std::map.
+  typedef typename vector<pair<typename UniqueEntity<Key>::Id, Value>>::iterator MutIter;
+  MutIter find(typename UniqueEntity<Key>::Id);
+  Iter find(typename UniqueEntity<Key>::Id) const;
+  vector<pair<typename UniqueEntity<Key>::Id, Value>> elems;
 };
 
 #endif
@@ -35,17 +35,17 @@ EntitySet<Creature>::EntitySet(const vector<Creature*>&);
 
 template <class T>
 void EntitySet<T>::insert(const T* e) {
-  elems.insert(e->getUniqueId());
+  insert(e->getUniqueId());
 }
 
 template <class T>
 void EntitySet<T>::erase(const T* e) {
-  elems.erase(e->getUniqueId());
+  erase(e->getUniqueId());
 }
 
 template <class T>
 bool EntitySet<T>::contains(const T* e) const {
-  return elems.count(e->getUniqueId());
+  return contains(e->getUniqueId());
 }
 
 template <class T>
@@ -60,7 +60,9 @@ int EntitySet<T>::getSize() const {
 
 template <class T>
 void EntitySet<T>::insert(typename UniqueEntity<T>::Id e) {
-  elems.insert(e);
+  auto it = std::lower_bound(elems.begin(), elems.end(), e);
+  if (it == elems.end() || *it != e)
+    elems.insert(it, e);
 }
 
 template <class T>
@@ -70,18 +72,26 @@ void EntitySet<T>::clear() {
 
 template <class T>
 void EntitySet<T>::erase(typename UniqueEntity<T>::Id e) {
-  elems.erase(e);
+  auto it = std::lower_bound(elems.begin(), elems.end(), e);
+  if (it != elems.end() && *it == e)
+    elems.erase(it);
 }
 
 template <class T>
 bool EntitySet<T>::contains(typename UniqueEntity<T>::Id e) const {
-  return elems.count(e);
+  return std::binary_search(elems.begin(), elems.end(), e);
 }
 
 template <class T>
 template <class Archive> 
 void EntitySet<T>::serialize(Archive& ar, const unsigned int version) {
-  ar & SVAR(elems);
+  // Saved as a std::set to stay compatible with older saves.
+  set<typename UniqueEntity<T>::Id> asSet;
+  if (!Archive::is_loading::value)
+    asSet.insert(elems.begin(), elems.end());
+  ar & boost::serialization::make_nvp("elems", asSet);
+  if (Archive::is_loading::value)
+    elems.assign(asSet.begin(), asSet.end());
 }
 
 template <class T>
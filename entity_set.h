@@ -42,13 +42,14 @@ class EntitySet {
 
   ItemPredicate containsPredicate() const;
 
-  typedef typename set<typename UniqueEntity<T>::Id>::const_iterator Iter;
+  typedef typename vector<typename UniqueEntity<T>::Id>::const_iterator Iter;
 
   Iter begin() const;
   Iter end() const;
 
   private:
-  set<typename UniqueEntity<T>::Id> SERIAL(elems);
+  // Kept sorted, so iteration order is the same as it would be for a std::set.
+  vector<typename UniqueEntity<T>::Id> elems;
 };
 
 #endif
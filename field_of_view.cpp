@@ -51,14 +51,24 @@ bool FieldOfView::canSee(Vec2 from, Vec2 to) {
   if ((from - to).lengthD() > sightRange)
     return false;
   if (!visibility[from])
-    visibility[from].reset(new Visibility(*squares, vision, from.x, from.y));
+    visibility[from].reset(new Visibility(getBlocking(), from.x, from.y));
   return visibility[from]->checkVisible(to.x - from.x, to.y - from.y);
 }
   
+const Table<bool>& FieldOfView::getBlocking() {
+  if (!blocking) {
+    blocking = Table<bool>(squares->getBounds());
+    for (Vec2 v : squares->getBounds())
+      (*blocking)[v] = !squares->getReadonly(v)->canSeeThru(vision);
+  }
+  return *blocking;
+}
+
 void FieldOfView::squareChanged(Vec2 pos) {
-  vector<Vec2> updateList;
+  if (blocking)
+    (*blocking)[pos] = !squares->getReadonly(pos)->canSeeThru(vision);
   if (!visibility[pos])
-    visibility[pos].reset(new Visibility(*squares, vision, pos.x, pos.y));
+    visibility[pos].reset(new Visibility(getBlocking(), pos.x, pos.y));
   vector<Vec2> visible = visibility[pos]->getVisibleTiles();
   for (Vec2 v : visible)
     if (visibility[v] && visibility[v]->checkVisible(pos.x - v.x, pos.y - v.y)) {
@@ -76,19 +86,19 @@ void FieldOfView::Visibility::setVisible(int x, int y) {
 static int totalIter = 0;
 static int numSamples = 0;
 
-FieldOfView::Visibility::Visibility(const SquareArray& squares, VisionId vision, int x, int y) : px(x), py(y) {
+FieldOfView::Visibility::Visibility(const Table<bool>& blocking, int x, int y) : px(x), py(y) {
   memset(visible, 0, (2 * sightRange + 1) * (2 * sightRange + 1));
   calculate(2 * sightRange, 2 * sightRange,2 * sightRange, 2,-1,1,1,1,
-      [&](int px, int py) { return !squares.getReadonly(Vec2(x + px, y + py))->canSeeThru(vision); },
+      [&](int px, int py) { return blocking[Vec2(x + px, y + py)]; },
       [&](int px, int py) { setVisible(px ,py); });
   calculate(2 * sightRange, 2 * sightRange,2 * sightRange, 2,-1,1,1,1,
-      [&](int px, int py) { return !squares.getReadonly(Vec2(x + py, y - px))->canSeeThru(vision); },
+      [&](int px, int py) { return blocking[Vec2(x + py, y - px)]; },
       [&](int px, int py) { setVisible(py, -px); });
   calculate(2 * sightRange, 2 * sightRange,2 * sightRange,2,-1,1,1,1,
-      [&](int px, int py) { return !squares.getReadonly(Vec2(x - px, y - py))->canSeeThru(vision); },
+      [&](int px, int py) { return blocking[Vec2(x - px, y - py)]; },
       [&](int px, int py) { setVisible(-px, -py); });
   calculate(2 * sightRange, 2 * sightRange,2 * sightRange,2,-1,1,1,1,
-      [&](int px, int py) { return !squares.getReadonly(Vec2(x - py, y + px))->canSeeThru(vision); },
+      [&](int px, int py) { return blocking[Vec2(x - py, y + px)]; },
       [&](int px, int py) { setVisible(-py, px); });
   setVisible(0, 0);
 /*  ++numSamples;
@@ -103,7 +113,7 @@ const vector<Vec2>& FieldOfView::Visibility::getVisibleTiles() const {
 
 const vector<Vec2>& FieldOfView::getVisibleTiles(Vec2 from) {
   if (!visibility[from]) {
-    visibility[from].reset(new Visibility(*squares, vision, from.x, from.y));
+    visibility[from].reset(new Visibility(getBlocking(), from.x, from.y));
   }
   return visibility[from]->getVisibleTiles();
 }
@@ -41,7 +41,7 @@ class FieldOfView {
     bool checkVisible(int x,int y) const;
     const vector<Vec2>& getVisibleTiles() const;
 
-    Visibility(const SquareArray& squares, VisionId, int x, int y);
+    Visibility(const Table<bool>& blocking, int x, int y);
     Visibility(Visibility&&) = default;
     Visibility& operator = (Visibility&&) = default;
 
@@ -62,6 +62,9 @@ class FieldOfView {
   const SquareArray* SERIAL(squares);
   Table<unique_ptr<Visibility>> SERIAL(visibility);
   VisionId SERIAL(vision);
+  /** Compact copy of the squares' see-thru state, so that computing visibility doesn't touch Square objects.*/
+  const Table<bool>& getBlocking();
+  optional<Table<bool>> blocking;
 };
 
 #endif
@@ -32,6 +32,17 @@ GuiBuilder::GuiBuilder(Renderer& r, GuiFactory& g, Clock* c, Options* o, Callbac
 void GuiBuilder::reset() {
   gameSpeed = GameSpeed::NORMAL;
   numSeenVillains = -1;
+  technologyHash = 0;
+  tasksOverlayHash = 0;
+  messagesHash = 0;
+}
+
+int GuiBuilder::getNumRebuiltSections() const {
+  return numRebuiltSections;
+}
+
+void GuiBuilder::clearNumRebuiltSections() {
+  numRebuiltSections = 0;
 }
 
 void GuiBuilder::setMapGui(MapGui* g) {
@@ -175,21 +186,28 @@ PGuiElem GuiBuilder::drawBuildings(CollectiveInfo& info) {
     buildingsCache =  gui.scrollable(gui.verticalList(drawButtons(info.buildings, CollectiveTab::BUILDINGS),
           legendLineHeight), &buildingsScroll, &scrollbarsHeld);
     buildingsHash = newHash;
+    ++numRebuiltSections;
   }
   return gui.external(buildingsCache.get());
 }
 
 PGuiElem GuiBuilder::drawTechnology(CollectiveInfo& info) {
-  vector<PGuiElem> lines = drawButtons(info.libraryButtons, CollectiveTab::TECHNOLOGY);
-  for (int i : All(info.techButtons)) {
-    vector<PGuiElem> line;
-    line.push_back(gui.viewObject(info.techButtons[i].viewId));
-    line.push_back(gui.label(info.techButtons[i].name, colors[ColorId::WHITE], info.techButtons[i].hotkey));
-    lines.push_back(gui.stack(gui.buttonChar(
-          getButtonCallback(UserInput(UserInputId::TECHNOLOGY, i)), info.techButtons[i].hotkey),
-          gui.horizontalList(std::move(line), 35)));
+  int newHash = combineHash(info.libraryButtons, info.techButtons);
+  if (newHash != technologyHash) {
+    vector<PGuiElem> lines = drawButtons(info.libraryButtons, CollectiveTab::TECHNOLOGY);
+    for (int i : All(info.techButtons)) {
+      vector<PGuiElem> line;
+      line.push_back(gui.viewObject(info.techButtons[i].viewId));
+      line.push_back(gui.label(info.techButtons[i].name, colors[ColorId::WHITE], info.techButtons[i].hotkey));
+      lines.push_back(gui.stack(gui.buttonChar(
+            getButtonCallback(UserInput(UserInputId::TECHNOLOGY, i)), info.techButtons[i].hotkey),
+            gui.horizontalList(std::move(line), 35)));
+    }
+    technologyCache = gui.verticalList(std::move(lines), legendLineHeight);
+    technologyHash = newHash;
+    ++numRebuiltSections;
   }
-  return gui.verticalList(std::move(lines), legendLineHeight);
+  return gui.external(technologyCache.get());
 }
 
 PGuiElem GuiBuilder::drawKeeperHelp() {
@@ -268,6 +286,7 @@ PGuiElem GuiBuilder::drawBottomBandInfo(GameInfo& gameInfo) {
     bottomBandCache = gui.verticalList(makeVec<PGuiElem>(
           gui.centerHoriz(gui.horizontalList(std::move(topLine), resourceSpace), numTop * resourceSpace),
           gui.centerHoriz(gui.horizontalList(std::move(bottomLine), 140, 3), numBottom * 140)), 28);
+    ++numRebuiltSections;
   }
   return gui.external(bottomBandCache.get());
 }
@@ -934,6 +953,7 @@ PGuiElem GuiBuilder::drawTeams(CollectiveInfo& info) {
           gui.label("[new team]", colors[ColorId::WHITE]))));
     teamCache = lines.buildVerticalList();
     teamHash = newHash;
+    ++numRebuiltSections;
   }
   return gui.external(teamCache.get());
 }
@@ -999,26 +1019,32 @@ const int taskMapWindowWidth = 400;
 void GuiBuilder::drawTasksOverlay(vector<OverlayInfo>& ret, CollectiveInfo& info) {
   if (info.taskMap.empty())
     return;
-  vector<PGuiElem> lines;
-  vector<PGuiElem> freeLines;
-  for (auto& elem : info.taskMap) {
-    if (elem.creature)
-      if (auto minion = info.getMinion(*elem.creature)) {
-        lines.push_back(gui.horizontalList(makeVec<PGuiElem>(
-                gui.viewObject(minion->viewId),
-                gui.label(elem.name, colors[elem.priority ? ColorId::GREEN : ColorId::WHITE])), 35));
-        continue;
-      }
-    freeLines.push_back(gui.horizontalList(makeVec<PGuiElem>(
-            gui.empty(),
-            gui.label(elem.name, colors[elem.priority ? ColorId::GREEN : ColorId::WHITE])), 35));
-  }
   int lineHeight = 25;
   int margin = 20;
-  append(lines, std::move(freeLines));
-  ret.push_back({gui.conditional(gui.miniWindow(
-        gui.margins(gui.scrollable(gui.verticalList(std::move(lines), lineHeight), &tasksScroll, &scrollbarsHeld),
-          margin)), [this] { return showTasks; }),
+  int newHash = combineHash(info.taskMap, info.minions);
+  if (newHash != tasksOverlayHash) {
+    vector<PGuiElem> lines;
+    vector<PGuiElem> freeLines;
+    for (auto& elem : info.taskMap) {
+      if (elem.creature)
+        if (auto minion = info.getMinion(*elem.creature)) {
+          lines.push_back(gui.horizontalList(makeVec<PGuiElem>(
+                  gui.viewObject(minion->viewId),
+                  gui.label(elem.name, colors[elem.priority ? ColorId::GREEN : ColorId::WHITE])), 35));
+          continue;
+        }
+      freeLines.push_back(gui.horizontalList(makeVec<PGuiElem>(
+              gui.empty(),
+              gui.label(elem.name, colors[elem.priority ? ColorId::GREEN : ColorId::WHITE])), 35));
+    }
+    append(lines, std::move(freeLines));
+    tasksOverlayCache = gui.conditional(gui.miniWindow(
+          gui.margins(gui.scrollable(gui.verticalList(std::move(lines), lineHeight), &tasksScroll,
+              &scrollbarsHeld), margin)), [this] { return showTasks; });
+    tasksOverlayHash = newHash;
+    ++numRebuiltSections;
+  }
+  ret.push_back({gui.external(tasksOverlayCache.get()),
       Vec2(taskMapWindowWidth, info.taskMap.size() * lineHeight + 2 * margin),
       OverlayInfo::TOP_RIGHT});
 }
@@ -1086,6 +1112,7 @@ void GuiBuilder::drawMinionsOverlay(vector<OverlayInfo>& ret, CollectiveInfo& in
             {gui.getKey(SDLK_ESCAPE)}, true),
           gui.margins(std::move(menu), margin)));
       minionsOverlayHash = newHash;
+      ++numRebuiltSections;
     }
     ret.push_back({gui.external(minionsOverlayCache.get()), size, OverlayInfo::MINIONS});
   }
@@ -1209,32 +1236,41 @@ void GuiBuilder::drawMessages(vector<OverlayInfo>& ret,
     const vector<PlayerMessage>& messageBuffer, int maxMessageLength) {
   int hMargin = 10;
   int vMargin = 5;
-  vector<vector<PlayerMessage>> messages = fitMessages(renderer, messageBuffer, maxMessageLength - 2 * hMargin,
-      getNumMessageLines());
   int lineHeight = 20;
-  vector<PGuiElem> lines;
-  for (int i : All(messages)) {
-    GuiFactory::ListBuilder line(gui);
-    for (auto& message : messages[i]) {
-      string text = (line.isEmpty() ? "" : " ") + message.getText();
-      cutToFit(renderer, text, maxMessageLength - 2 * hMargin);
-      if (message.isClickable()) {
+  int newHash = combineHash(messageBuffer, maxMessageLength);
+  if (newHash != messagesHash) {
+    vector<vector<PlayerMessage>> messages = fitMessages(renderer, messageBuffer, maxMessageLength - 2 * hMargin,
+        getNumMessageLines());
+    vector<PGuiElem> lines;
+    for (int i : All(messages)) {
+      GuiFactory::ListBuilder line(gui);
+      for (auto& message : messages[i]) {
+        string text = (line.isEmpty() ? "" : " ") + message.getText();
+        cutToFit(renderer, text, maxMessageLength - 2 * hMargin);
+        if (message.isClickable()) {
+          line.addElemAuto(gui.stack(
+                gui.button(getButtonCallback(UserInput(UserInputId::MESSAGE_INFO, message.getUniqueId()))),
+                gui.labelHighlight(text, getMessageColor(message))));
+          line.addElemAuto(gui.labelUnicode(u8"➚", getMessageColor(message)));
+        } else
         line.addElemAuto(gui.stack(
               gui.button(getButtonCallback(UserInput(UserInputId::MESSAGE_INFO, message.getUniqueId()))),
-              gui.labelHighlight(text, getMessageColor(message))));
-        line.addElemAuto(gui.labelUnicode(u8"➚", getMessageColor(message)));
-      } else
-      line.addElemAuto(gui.stack(
-            gui.button(getButtonCallback(UserInput(UserInputId::MESSAGE_INFO, message.getUniqueId()))),
-            gui.label(text, getMessageColor(message))));
+              gui.label(text, getMessageColor(message))));
+      }
+      if (!messages[i].empty())
+        lines.push_back(line.buildHorizontalList());
     }
-    if (!messages[i].empty())
-      lines.push_back(line.buildHorizontalList());
+    if (!lines.empty())
+      messagesCache = gui.translucentBackground(
+          gui.margins(gui.verticalList(std::move(lines), lineHeight), hMargin, vMargin, hMargin, vMargin));
+    else
+      messagesCache.reset();
+    messagesSize = Vec2(maxMessageLength, lineHeight * messages.size() + 15);
+    messagesHash = newHash;
+    ++numRebuiltSections;
   }
-  if (!lines.empty())
-    ret.push_back({gui.translucentBackground(
-        gui.margins(gui.verticalList(std::move(lines), lineHeight), hMargin, vMargin, hMargin, vMargin)),
-        Vec2(maxMessageLength, lineHeight * messages.size() + 15), OverlayInfo::MESSAGES});
+  if (messagesCache)
+    ret.push_back({gui.external(messagesCache.get()), messagesSize, OverlayInfo::MESSAGES});
 }
 
 PGuiElem GuiBuilder::getVillageStateLabel(VillageInfo::Village::State state) {
@@ -1300,6 +1336,7 @@ PGuiElem GuiBuilder::drawVillages(VillageInfo& info) {
   int currentHash = combineHash(info);
   if (currentHash != villagesHash) {
     villagesHash = currentHash;
+    ++numRebuiltSections;
     auto lines = gui.getListBuilder(legendLineHeight);
     int titleMargin = -11;
     lines.addElem(gui.leftMargin(titleMargin, gui.label(toString(info.numConquered) + "/" +
@@ -1548,7 +1585,8 @@ PGuiElem GuiBuilder::drawMinionButtons(const vector<PlayerInfo>& minions, Unique
       }
     }
     minionButtonsCache = gui.scrollable(list.buildVerticalList(), &minionButtonsScroll, &scrollbarsHeld);
-    cache = minionButtonsHash;
+    minionButtonsHash = cache;
+    ++numRebuiltSections;
   }
   return gui.external(minionButtonsCache.get());
 }
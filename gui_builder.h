@@ -121,6 +121,9 @@ class GuiBuilder {
       MenuType, int* height, int* highlight, int* choice);
   int getScrollPos(int index, int count);
   void setMapGui(MapGui*);
+  /** Returns the number of cached gui sections rebuilt since the last clearNumRebuiltSections call.*/
+  int getNumRebuiltSections() const;
+  void clearNumRebuiltSections();
 
   private:
   PGuiElem drawCampaignGrid(const Campaign&, optional<Vec2>* markedPos, function<bool(Vec2)> activeFun,
@@ -167,6 +170,14 @@ class GuiBuilder {
   GuiFactory::ListBuilder drawRetiredGames(RetiredGames&, function<void()> reloadCampaign, bool active);
   PGuiElem teamCache;
   int teamHash = 0;
+  PGuiElem technologyCache;
+  int technologyHash = 0;
+  PGuiElem tasksOverlayCache;
+  int tasksOverlayHash = 0;
+  PGuiElem messagesCache;
+  Vec2 messagesSize;
+  int messagesHash = 0;
+  int numRebuiltSections = 0;
   optional<string> activeGroup;
   struct ActiveButton {
     CollectiveTab tab;
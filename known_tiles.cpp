@@ -1,5 +1,6 @@
 #include "stdafx.h"
 #include "known_tiles.h"
+#include "level.h"
 
 template <class Archive>
 void KnownTiles::serialize(Archive& ar, const unsigned int version) {
@@ -10,10 +11,61 @@ SERIALIZABLE(KnownTiles);
 
 void KnownTiles::addTile(Position pos) {
   known.set(pos, true);
-  border.erase(pos);
+  if (border.erase(pos) && borderIndexUpToDate && pos.isValid())
+    getBorderIndex(pos.getLevel()).removeElement(pos.getCoord(), pos.getCoord());
   for (Position v : pos.neighbors4())
-    if (!known.get(v))
-      border.insert(v);
+    if (!known.get(v) && border.insert(v).second && borderIndexUpToDate && v.isValid())
+      getBorderIndex(v.getLevel()).addElement(v.getCoord(), v.getCoord());
+}
+
+const static int borderBucketSize = 8;
+
+BucketMap<Vec2>& KnownTiles::getBorderIndex(Level* level) const {
+  if (!borderIndexUpToDate) {
+    borderIndexUpToDate = true;
+    borderIndex.clear();
+    for (Position pos : border)
+      if (pos.isValid())
+        getBorderIndex(pos.getLevel()).addElement(pos.getCoord(), pos.getCoord());
+  }
+  auto index = borderIndex.find(level);
+  if (index == borderIndex.end()) {
+    Rectangle bounds = level->getBounds();
+    index = borderIndex.insert(make_pair(level,
+          BucketMap<Vec2>(bounds.right(), bounds.bottom(), borderBucketSize))).first;
+  }
+  return index->second;
+}
+
+vector<Position> KnownTiles::getCloseBorderTiles(Position from, Level* level, double maxDiff,
+    function<bool(Position)> predicate) const {
+  const BucketMap<Vec2>& index = getBorderIndex(level);
+  vector<Position> ret;
+  if (!from.isSameLevel(level)) {
+    // All tiles are equally far away, so every one is a candidate.
+    for (Position pos : border)
+      if (pos.isSameLevel(level) && pos.isValid() && predicate(pos))
+        ret.push_back(pos);
+    return ret;
+  }
+  optional<int> closest;
+  for (int ring : Range(index.getMaxRing(from.getCoord()) + 1)) {
+    if (closest && index.getMinDistance(ring) > *closest * (1 + maxDiff))
+      break;
+    for (Vec2 v : index.getElementsInRing(from.getCoord(), ring)) {
+      Position pos(v, level);
+      if (predicate(pos)) {
+        ret.push_back(pos);
+        int dist = pos.dist8(from);
+        if (!closest || dist < *closest)
+          closest = dist;
+      }
+    }
+  }
+  ret = filter(ret, [&] (Position pos) { return pos.dist8(from) <= *closest * (1 + maxDiff); });
+  // Bucket contents are unordered, sort them so that callers stay deterministic.
+  std::sort(ret.begin(), ret.end());
+  return ret;
 }
 
 const set<Position>& KnownTiles::getBorderTiles() const {
@@ -30,5 +82,6 @@ void KnownTiles::limitToModel(const Model* m) {
     if (p.getModel() == m)
       copy.insert(p);
   border = copy;
+  borderIndexUpToDate = false;
   known.limitToModel(m);
 }
@@ -17,12 +17,17 @@
 
 #include "util.h"
 #include "position_map.h"
+#include "bucket_map.h"
 
 class KnownTiles {
   public:
   void addTile(Position);
   bool isKnown(Position) const;
   const set<Position>& getBorderTiles() const;
+  // Returns the border tiles on the given level that satisfy the predicate and are at most
+  // (1 + maxDiff) times further from 'from' than the closest such tile.
+  vector<Position> getCloseBorderTiles(Position from, Level*, double maxDiff,
+      function<bool(Position)> predicate) const;
   void limitToModel(const Model*);
 
   template <class Archive> 
@@ -31,6 +36,9 @@ class KnownTiles {
   private:
   PositionMap<bool> SERIAL(known);
   set<Position> SERIAL(border);
+  BucketMap<Vec2>& getBorderIndex(Level*) const;
+  mutable map<Level*, BucketMap<Vec2>> borderIndex;
+  mutable bool borderIndexUpToDate = false;
 };
 
 #endif
@@ -4,6 +4,7 @@
 #include "view_object.h"
 #include "player_message.h"
 #include "creature_attributes.h"
+#include "tribe.h"
 
 void LastingEffects::onAffected(Creature* c, LastingEffect effect, bool msg) {
   switch (effect) {
@@ -59,7 +60,11 @@ void LastingEffects::onAffected(Creature* c, LastingEffect effect, bool msg) {
       c->removeEffect(LastingEffect::POISON, true);
       break;
     case LastingEffect::FIRE_RESISTANT: if (msg) c->you(MsgType::ARE, "now fire resistant"); break;
-    case LastingEffect::INSANITY: if (msg) c->you(MsgType::BECOME, "insane"); break;
+    case LastingEffect::INSANITY:
+      if (msg)
+        c->you(MsgType::BECOME, "insane");
+      Tribe::onRelationsChanged();
+      break;
     case LastingEffect::MAGIC_SHIELD: if (msg) c->you(MsgType::FEEL, "protected"); break;
     case LastingEffect::DARKNESS_SOURCE: break;
   }
@@ -124,7 +129,11 @@ void LastingEffects::onTimedOut(Creature* c, LastingEffect effect, bool msg) {
       if (msg)
         c->you(MsgType::FALL, "on the " + c->getPosition().getName());
       break;
-    case LastingEffect::INSANITY: if (msg) c->you(MsgType::BECOME, "sane again"); break;
+    case LastingEffect::INSANITY:
+      if (msg)
+        c->you(MsgType::BECOME, "sane again");
+      Tribe::onRelationsChanged();
+      break;
     case LastingEffect::MAGIC_SHIELD: if (msg) c->you(MsgType::FEEL, "less protected"); break;
     case LastingEffect::PREGNANT: break;
     case LastingEffect::DARKNESS_SOURCE: break;
@@ -20,6 +20,7 @@
 #include "model.h"
 #include "item.h"
 #include "creature.h"
+#include "tribe.h"
 #include "square.h"
 #include "collective_builder.h"
 #include "trigger.h"
@@ -39,8 +40,26 @@
 template <class Archive> 
 void Level::serialize(Archive& ar, const unsigned int version) {
   serializeAll(ar, squares, oldSquares, landingSquares, locations, tickingSquares, creatures, model, fieldOfView);
-  serializeAll(ar, name, backgroundLevel, backgroundOffset, sunlight, bucketMap, sectors, lightAmount, unavailable);
-  serializeAll(ar, levelId, noDiagonalPassing, lightCapAmount, creatureIds, background, squareMemoryDirty);
+  serializeAll(ar, name, backgroundLevel, backgroundOffset, sunlight, bucketMap);
+  if (version == 0) {
+    unordered_map<MovementType, Sectors> sectors;
+    ar & SVAR(sectors);
+    for (auto& elem : sectors) {
+      this->sectors.push_back(elem.second);
+      sectorsMembers.push_back({elem.first});
+    }
+  } else
+    serializeAll(ar, sectors, sectorsMembers);
+  if (Archive::is_loading::value)
+    initSectorsIndex();
+  if (version < 2) {
+    // Older saves stored the light tables, they are now rebuilt on first use.
+    Table<double> lightAmount;
+    serializeAll(ar, lightAmount, unavailable);
+    Table<double> lightCapAmount;
+    serializeAll(ar, levelId, noDiagonalPassing, lightCapAmount, creatureIds, background, squareMemoryDirty);
+  } else
+    serializeAll(ar, unavailable, levelId, noDiagonalPassing, creatureIds, background, squareMemoryDirty);
 }  
 
 SERIALIZABLE(Level);
@@ -54,8 +73,7 @@ Level::Level(SquareArray s, Model* m, vector<Location*> l, const string& n,
     : squares(std::move(s)), oldSquares(squares.getBounds()), squareMemoryDirty(squares.getBounds(), true),
       locations(l), model(m), 
       name(n), sunlight(sun), bucketMap(squares.getBounds().width(), squares.getBounds().height(),
-      FieldOfView::sightRange), lightAmount(squares.getBounds(), 0), lightCapAmount(squares.getBounds(), 1),
-      levelId(id) {
+      FieldOfView::sightRange), levelId(id) {
   for (Vec2 pos : squares.getBounds()) {
     const Square* square = squares.getReadonly(pos);
     square->onAddedToLevel(Position(pos, this));
@@ -66,8 +84,6 @@ Level::Level(SquareArray s, Model* m, vector<Location*> l, const string& n,
     l->setLevel(this);
   for (VisionId vision : ENUM_ALL(VisionId))
     fieldOfView[vision] = FieldOfView(squares, vision);
-  for (Vec2 pos : squares.getBounds())
-    addLightSource(pos, squares.getReadonly(pos)->getLightEmission(), 1);
 }
 
 LevelId Level::getUniqueId() const {
@@ -93,8 +109,6 @@ void Level::addCreature(Vec2 position, PCreature c, double delay) {
   putCreature(position, ref);
 }
 
-const static double darknessRadius = 3.5;
-
 void Level::putCreature(Vec2 position, Creature* c) {
   CHECK(inBounds(position));
   creatures.push_back(c);
@@ -103,35 +117,116 @@ void Level::putCreature(Vec2 position, Creature* c) {
   placeCreature(c, position);
 }
 
-void Level::addLightSource(Vec2 pos, double radius) {
-  addLightSource(pos, radius, 1);
-}
+/** Light and darkness are stored in fixed point. Each source remembers the exact contributions it made,
+  so removing it restores the previous values regardless of the order of updates.*/
+const static int lightScale = 1000;
 
-void Level::removeLightSource(Vec2 pos, double radius) {
-  addLightSource(pos, radius, -1);
-}
+struct Level::LightMap {
+  LightMap(Rectangle bounds, int initial) : amount(bounds, initial), index(bounds.width(), bounds.height(), 10),
+      dirty(bounds, false) {}
+
+  struct Source {
+    double radius;
+    vector<pair<Vec2, int>> contribution;
+  };
 
-void Level::addLightSource(Vec2 pos, double radius, int numLight) {
-  if (radius > 0) {
-    for (Vec2 v : getVisibleTilesNoDarkness(pos, VisionId::NORMAL)) {
-      double dist = (v - pos).lengthD();
-      if (dist <= radius)
-        lightAmount[v] += min(1.0, 1 - (dist) / radius) * numLight;
+  void markDirty(Vec2 pos) {
+    if (!dirty[pos]) {
+      dirty[pos] = true;
+      dirtyList.push_back(pos);
     }
   }
-}
 
-void Level::addDarknessSource(Vec2 pos, double radius, int numDarkness) {
-  if (radius > 0) {
-    for (Vec2 v : getVisibleTilesNoDarkness(pos, VisionId::NORMAL)) {
-      double dist = (v - pos).lengthD();
-      if (dist <= radius) {
-        lightCapAmount[v] -= min(1.0, 1 - (dist) / radius) * numDarkness;
-      //  squares.getSquare(v)->setCovered(true);
+  /** Marks all sources that might light the square, so that they are recomputed if it starts or stops blocking vision.*/
+  void markDirtyAround(Vec2 pos) {
+    for (Vec2 v : index.getElements(Rectangle::centered(pos, (int) ceil(maxRadius))))
+      if ((v - pos).lengthD() <= sources.at(v).radius)
+        markDirty(v);
+  }
+
+  Table<int> amount;
+  unordered_map<Vec2, Source, CustomHash<Vec2>> sources;
+  BucketMap<Vec2> index;
+  double maxRadius = 0;
+  Table<bool> dirty;
+  vector<Vec2> dirtyList;
+};
+
+void Level::updateLightMap(LightMap& map, function<double(Vec2)> getRadius) const {
+  for (Vec2 pos : map.dirtyList) {
+    map.dirty[pos] = false;
+    auto it = map.sources.find(pos);
+    if (it != map.sources.end()) {
+      for (auto& elem : it->second.contribution)
+        map.amount[elem.first] -= elem.second;
+      map.sources.erase(it);
+      map.index.removeElement(pos, pos);
+    }
+    double radius = getRadius(pos);
+    if (radius > 0) {
+      LightMap::Source& source = map.sources[pos];
+      source.radius = radius;
+      for (Vec2 v : getFieldOfView(VisionId::NORMAL).getVisibleTiles(pos)) {
+        double dist = (v - pos).lengthD();
+        if (dist <= radius) {
+          int value = (int) round(min(1.0, 1 - dist / radius) * lightScale);
+          map.amount[v] += value;
+          source.contribution.push_back(make_pair(v, value));
+        }
       }
-      updateConnectivity(v);
+      map.index.addElement(pos, pos);
+      map.maxRadius = max(map.maxRadius, radius);
     }
   }
+  map.dirtyList.clear();
+}
+
+Level::LightMap& Level::getLightMap() const {
+  if (!light) {
+    light.reset(new LightMap(getBounds(), 0));
+    for (Vec2 v : getBounds())
+      if (squares.getReadonly(v)->getLightEmission() > 0)
+        light->markDirty(v);
+  }
+  if (!light->dirtyList.empty())
+    updateLightMap(*light, [this] (Vec2 v) { return squares.getReadonly(v)->getLightEmission(); });
+  return *light;
+}
+
+const static double darknessRadius = 3.5;
+
+Level::LightMap& Level::getDarknessMap() const {
+  if (!darkness) {
+    darkness.reset(new LightMap(getBounds(), 0));
+    for (const Creature* c : creatures)
+      if (c->isDarknessSource())
+        darkness->markDirty(c->getPosition().getCoord());
+  }
+  if (!darkness->dirtyList.empty())
+    updateLightMap(*darkness, [this] (Vec2 v) {
+        const Creature* c = squares.getReadonly(v)->getCreature();
+        return c && c->isDarknessSource() ? darknessRadius : 0; });
+  return *darkness;
+}
+
+void Level::updateLightSource(Vec2 pos) {
+  if (light) {
+    light->markDirty(pos);
+    double radius = max(light->maxRadius, squares.getReadonly(pos)->getLightEmission());
+    invalidateVisibleCreatures(pos, FieldOfView::sightRange + (int) ceil(radius));
+  }
+}
+
+void Level::markLightChanged(Vec2 pos) {
+  // The sources marked here light squares up to twice their radius away from the changed square.
+  if (light) {
+    light->markDirtyAround(pos);
+    invalidateVisibleCreatures(pos, FieldOfView::sightRange + 2 * (int) ceil(light->maxRadius));
+  }
+  if (darkness) {
+    darkness->markDirtyAround(pos);
+    invalidateVisibleCreatures(pos, FieldOfView::sightRange + 2 * (int) ceil(darkness->maxRadius));
+  }
 }
 
 void Level::removeSquare(Position pos, PSquare defaultSquare) {
@@ -151,7 +246,6 @@ void Level::replaceSquare(Position position, PSquare newSquare, bool storePrevio
   for (Item* it : copyOf(oldSquare->getItems()))
     newSquare->dropItem(position, oldSquare->removeItem(position, it));
   newSquare->setCovered(oldSquare->isCovered());
-  addLightSource(pos, oldSquare->getLightEmission(), -1);
   for (PTrigger& t : oldSquare->removeTriggers(position))
     newSquare->addTrigger(position, std::move(t));
   if (auto backgroundObj = oldSquare->extractBackground())
@@ -164,26 +258,16 @@ void Level::replaceSquare(Position position, PSquare newSquare, bool storePrevio
   if (c) {
     squares.getSquare(pos)->setCreature(c);
   }
-  addLightSource(pos, squares.getSquare(pos)->getLightEmission(), 1);
+  updateLightSource(pos);
   updateVisibility(pos);
   updateConnectivity(pos);
 }
 
 void Level::updateVisibility(Vec2 changedSquare) {
-  for (Vec2 pos : getVisibleTilesNoDarkness(changedSquare, VisionId::NORMAL)) {
-    addLightSource(pos, squares.getReadonly(pos)->getLightEmission(), -1);
-    if (Creature* c = squares.getReadonly(pos)->getCreature())
-      if (c->isDarknessSource())
-        addDarknessSource(pos, darknessRadius, -1);
-  }
   for (VisionId vision : ENUM_ALL(VisionId))
     fieldOfView[vision].squareChanged(changedSquare);
-  for (Vec2 pos : getVisibleTilesNoDarkness(changedSquare, VisionId::NORMAL)) {
-    addLightSource(pos, squares.getReadonly(pos)->getLightEmission(), 1);
-    if (Creature* c = squares.getReadonly(pos)->getCreature())
-      if (c->isDarknessSource())
-        addDarknessSource(pos, darknessRadius, 1);
-  }
+  invalidateVisibleCreatures(changedSquare, FieldOfView::sightRange);
+  markLightChanged(changedSquare);
 }
 
 Creature* Level::getPlayer() const {
@@ -220,12 +304,14 @@ Game* Level::getGame() const {
 }
 
 bool Level::isInSunlight(Vec2 pos) const {
-  return !getSafeSquare(pos)->isCovered() && lightCapAmount[pos] == 1 &&
+  return !getSafeSquare(pos)->isCovered() && getDarknessMap().amount[pos] == 0 &&
       getGame()->getSunlightInfo().getState() == SunlightState::DAY;
 }
 
 double Level::getLight(Vec2 pos) const {
-  return max(0.0, min(getSafeSquare(pos)->isCovered() ? 1 : lightCapAmount[pos], lightAmount[pos] +
+  double lightCap = 1 - double(getDarknessMap().amount[pos]) / lightScale;
+  double lightAmount = double(getLightMap().amount[pos]) / lightScale;
+  return max(0.0, min(getSafeSquare(pos)->isCovered() ? 1 : lightCap, lightAmount +
       sunlight[pos] * getGame()->getSunlightInfo().getLightAmount()));
 }
 
@@ -420,6 +506,7 @@ void Level::eraseCreature(Creature* c, Vec2 coord) {
   removeElement(creatures, c);
   unplaceCreature(c, coord);
   creatureIds.erase(c);
+  removeVisibleCreature(c);
 }
 
 const vector<Creature*>& Level::getAllCreatures() const {
@@ -434,6 +521,146 @@ vector<Creature*> Level::getAllCreatures(Rectangle bounds) const {
   return bucketMap->getElements(bounds);
 }
 
+const Level::VisibleCreatures& Level::getVisibleCreatures(const Creature* c) const {
+  int turn = model->getTime();
+  if (visibleCreaturesTurn != turn) {
+    updateVisibleCreatures();
+    visibleCreaturesTurn = turn;
+    visibleCreaturesRelations = Tribe::getRelationsVersion();
+  } else {
+    if (visibleCreaturesRelations != Tribe::getRelationsVersion()) {
+      updateVisibleEnemies();
+      visibleCreaturesRelations = Tribe::getRelationsVersion();
+    }
+    flushVisibleCreatures();
+  }
+  return visibleCreatures.at(c);
+}
+
+void Level::updateCreatureVisibility(Creature* c) {
+  if (visibleCreaturesTurn && changedCreatures.insert(c).second)
+    changedCreaturesList.push_back(c);
+}
+
+void Level::invalidateVisibleCreatures(Vec2 pos, int radius) const {
+  if (visibleCreaturesTurn)
+    for (Creature* c : bucketMap->getElements(Rectangle::centered(pos, radius)))
+      if (changedObservers.insert(c).second)
+        changedObserversList.push_back(c);
+}
+
+void Level::flushVisibleCreatures() const {
+  // Changed creatures are processed both as observers and as targets. Only observers are affected by
+  // changes to squares and light, since a creature's own square is part of its line of sight.
+  for (Creature* c : changedCreaturesList) {
+    updateVisibleCreaturesAsTarget(c);
+    updateVisibleCreatures(c);
+  }
+  for (Creature* c : changedObserversList)
+    if (!changedCreatures.count(c))
+      updateVisibleCreatures(c);
+  changedCreatures.clear();
+  changedCreaturesList.clear();
+  changedObservers.clear();
+  changedObserversList.clear();
+}
+
+void Level::updateVisibleCreatures(Creature* c) const {
+  VisibleCreatures& visible = visibleCreatures[c];
+  for (Creature* other : visible.creatures)
+    visibleCreaturesSeenBy[other].erase(c);
+  visible.creatures.clear();
+  visible.enemies.clear();
+  for (Creature* other : c->getPosition().getAllCreatures(FieldOfView::sightRange))
+    if (c->canSee(other)) {
+      visible.creatures.push_back(other);
+      visibleCreaturesSeenBy[other].insert(c);
+      if (c->isEnemy(other))
+        visible.enemies.push_back(other);
+    }
+}
+
+void Level::updateVisibleCreaturesAsTarget(Creature* c) const {
+  auto& seenBy = visibleCreaturesSeenBy[c];
+  for (Creature* other : seenBy) {
+    VisibleCreatures& visible = visibleCreatures.at(other);
+    removeElementMaybe(visible.creatures, c);
+    removeElementMaybe(visible.enemies, c);
+  }
+  seenBy.clear();
+  for (Creature* other : c->getPosition().getAllCreatures(FieldOfView::sightRange))
+    if (other != c && other->canSee(c)) {
+      VisibleCreatures& visible = visibleCreatures[other];
+      visible.creatures.push_back(c);
+      seenBy.insert(other);
+      if (other->isEnemy(c))
+        visible.enemies.push_back(c);
+    }
+}
+
+void Level::removeVisibleCreature(Creature* c) {
+  if (!visibleCreaturesTurn)
+    return;
+  auto it = visibleCreatures.find(c);
+  if (it != visibleCreatures.end()) {
+    for (Creature* other : it->second.creatures)
+      visibleCreaturesSeenBy[other].erase(c);
+    visibleCreatures.erase(it);
+  }
+  for (Creature* other : visibleCreaturesSeenBy[c]) {
+    VisibleCreatures& visible = visibleCreatures.at(other);
+    removeElementMaybe(visible.creatures, c);
+    removeElementMaybe(visible.enemies, c);
+  }
+  visibleCreaturesSeenBy.erase(c);
+  if (changedCreatures.erase(c))
+    removeElement(changedCreaturesList, c);
+  if (changedObservers.erase(c))
+    removeElement(changedObserversList, c);
+}
+
+void Level::updateVisibleCreatures() const {
+  visibleCreatures.clear();
+  visibleCreaturesSeenBy.clear();
+  changedCreatures.clear();
+  changedCreaturesList.clear();
+  changedObservers.clear();
+  changedObserversList.clear();
+  unordered_map<const Creature*, int> index;
+  for (int i : All(creatures)) {
+    index[creatures[i]] = i;
+    visibleCreatures[creatures[i]];
+  }
+  auto add = [&] (Creature* c1, Creature* c2, bool enemy) {
+    auto& visible = visibleCreatures.at(c1);
+    visible.creatures.push_back(c2);
+    visibleCreaturesSeenBy[c2].insert(c1);
+    if (enemy)
+      visible.enemies.push_back(c2);
+  };
+  // The search area is symmetric, so every pair is visited once, from the creature with the lower index.
+  for (int i : All(creatures)) {
+    Creature* c1 = creatures[i];
+    for (Creature* c2 : c1->getPosition().getAllCreatures(FieldOfView::sightRange)) {
+      int j = index.at(c2);
+      if (j < i)
+        continue;
+      bool sees12 = c1->canSee(c2);
+      bool sees21 = j > i && c2->canSee(c1);
+      if (!sees12 && !sees21)
+        continue;
+      bool enemy12 = c1->isEnemy(c2);
+      // Hostility is mutual, unless one of the creatures is insane.
+      bool enemy21 = (c1->isAffected(LastingEffect::INSANITY) || c2->isAffected(LastingEffect::INSANITY)) ?
+          c2->isEnemy(c1) : enemy12;
+      if (sees12)
+        add(c1, c2, enemy12);
+      if (sees21)
+        add(c2, c1, enemy21);
+    }
+  }
+}
+
 bool Level::containsCreature(UniqueEntity<Creature>::Id id) const {
   return creatureIds.contains(id);
 }
@@ -497,16 +724,26 @@ void Level::moveCreature(Creature* creature, Vec2 direction) {
 void Level::unplaceCreature(Creature* creature, Vec2 pos) {
   bucketMap->removeElement(pos, creature);
   modSafeSquare(pos)->removeCreature(Position(pos, this));
-  if (creature->isDarknessSource())   
-    addDarknessSource(pos, darknessRadius, -1);
+  // Stationary creatures block navigation, and getSectors is used in place of Square::canNavigate.
+  if (creature->getAttributes().isStationary())
+    updateConnectivity(pos);
+  if (creature->isDarknessSource() && darkness) {
+    darkness->markDirty(pos);
+    invalidateVisibleCreatures(pos, FieldOfView::sightRange + (int) ceil(darknessRadius));
+  }
 }
 
 void Level::placeCreature(Creature* creature, Vec2 pos) {
   creature->setPosition(Position(pos, this));
+  updateCreatureVisibility(creature);
   bucketMap->addElement(pos, creature);
   modSafeSquare(pos)->putCreature(creature);
-  if (creature->isDarknessSource())
-    addDarknessSource(pos, darknessRadius, 1);
+  if (creature->getAttributes().isStationary())
+    updateConnectivity(pos);
+  if (creature->isDarknessSource() && darkness) {
+    darkness->markDirty(pos);
+    invalidateVisibleCreatures(pos, FieldOfView::sightRange + (int) ceil(darknessRadius));
+  }
 }
 
 void Level::swapCreatures(Creature* c1, Creature* c2) {
@@ -583,26 +820,116 @@ const string& Level::getName() const {
 }
 
 void Level::updateConnectivity(Vec2 pos) {
-  for (auto& elem : sectors)
-    if (getSafeSquare(pos)->canNavigate(elem.first))
-      elem.second.add(pos);
+  const Square* square = getSafeSquare(pos);
+  for (int i : Range(sectors.size())) {
+    vector<MovementType> navigable;
+    vector<MovementType> blocked;
+    for (auto& movement : sectorsMembers[i])
+      (square->canNavigate(movement) ? navigable : blocked).push_back(movement);
+    if (!navigable.empty() && !blocked.empty()) {
+      sectors.push_back(sectors[i]);
+      setSectorsSignature(sectors.size() - 1, sectorsSignature[i]);
+      removeFromSectors(sectors.size() - 1, pos);
+      for (auto& movement : blocked)
+        sectorsIndex[movement] = sectors.size() - 1;
+      sectorsMembers.push_back(std::move(blocked));
+      sectorsMembers[i] = std::move(navigable);
+      addToSectors(i, pos);
+    } else if (!navigable.empty())
+      addToSectors(i, pos);
     else
-      elem.second.remove(pos);
+      removeFromSectors(i, pos);
+  }
 }
 
 bool Level::areConnected(Vec2 p1, Vec2 p2, const MovementType& movement) const {
   return inBounds(p1) && inBounds(p2) && getSectors(movement).same(p1, p2);
 }
 
-Sectors& Level::getSectors(const MovementType& movement) const {
-  if (!sectors.count(movement)) {
-    sectors[movement] = Sectors(getBounds());
-    Sectors& newSectors = sectors.at(movement);
+static size_t getSectorsHash(Vec2 v) {
+  // The splitmix64 finalizer spreads the bits, so XORs of hashes of different sets of squares rarely collide.
+  uint64_t z = ((uint64_t) (uint32_t) v.x << 32 | (uint32_t) v.y) + 0x9e3779b97f4a7c15ULL;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+void Level::setSectorsSignature(int index, size_t signature) const {
+  if (index < sectorsSignature.size()) {
+    auto range = sectorsBySignature.equal_range(sectorsSignature[index]);
+    for (auto it = range.first; it != range.second; ++it)
+      if (it->second == index) {
+        sectorsBySignature.erase(it);
+        break;
+      }
+  } else
+    sectorsSignature.resize(index + 1);
+  sectorsSignature[index] = signature;
+  sectorsBySignature.insert(make_pair(signature, index));
+}
+
+void Level::addToSectors(int index, Vec2 pos) const {
+  if (!sectors[index].contains(pos)) {
+    sectors[index].add(pos);
+    setSectorsSignature(index, sectorsSignature[index] ^ getSectorsHash(pos));
+  }
+}
+
+void Level::removeFromSectors(int index, Vec2 pos) const {
+  if (sectors[index].contains(pos)) {
+    sectors[index].remove(pos);
+    setSectorsSignature(index, sectorsSignature[index] ^ getSectorsHash(pos));
+  }
+}
+
+const Sectors& Level::getSectors(const MovementType& movement) const {
+  auto it = sectorsIndex.find(movement);
+  if (it != sectorsIndex.end())
+    return sectors[it->second];
+  Table<bool> navigable(getBounds());
+  size_t signature = 0;
+  for (Vec2 v : getBounds())
+    if ((navigable[v] = getSafeSquare(v)->canNavigate(movement)))
+      signature ^= getSectorsHash(v);
+  auto isSame = [&] (const Sectors& s) {
+    for (Vec2 v : getBounds())
+      if (s.contains(v) != navigable[v])
+        return false;
+    return true;
+  };
+  optional<int> index;
+  auto candidates = sectorsBySignature.equal_range(signature);
+  for (auto it = candidates.first; it != candidates.second && !index; ++it)
+    if (isSame(sectors[it->second]))
+      index = it->second;
+  if (!index) {
+    index = (int) sectors.size();
+    sectors.push_back(Sectors(getBounds()));
+    sectorsMembers.emplace_back();
+    for (Vec2 v : getBounds())
+      if (navigable[v])
+        sectors.back().add(v);
+    setSectorsSignature(*index, signature);
+  }
+  sectorsMembers[*index].push_back(movement);
+  sectorsIndex[movement] = *index;
+  return sectors[*index];
+}
+
+void Level::initSectorsIndex() {
+  sectorsIndex.clear();
+  for (int i : All(sectorsMembers))
+    for (auto& movement : sectorsMembers[i])
+      sectorsIndex[movement] = i;
+  sectorsSignature.clear();
+  sectorsBySignature.clear();
+  for (int i : All(sectors)) {
+    size_t signature = 0;
     for (Vec2 v : getBounds())
-      if (getSafeSquare(v)->canNavigate(movement))
-        newSectors.add(v);
+      if (sectors[i].contains(v))
+        signature ^= getSectorsHash(v);
+    setSectorsSignature(i, signature);
   }
-  return sectors.at(movement);
 }
 
 bool Level::isChokePoint(Vec2 pos, const MovementType& movement) const {
@@ -611,6 +938,10 @@ bool Level::isChokePoint(Vec2 pos, const MovementType& movement) const {
 
 void Level::updateSunlightMovement() {
   sectors.clear();
+  sectorsMembers.clear();
+  sectorsIndex.clear();
+  sectorsSignature.clear();
+  sectorsBySignature.clear();
 }
 
 const optional<ViewObject>& Level::getBackgroundObject(Vec2 pos) const {
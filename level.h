@@ -157,6 +157,19 @@ class Level {
 
   bool containsCreature(UniqueEntity<Creature>::Id) const;
 
+  struct VisibleCreatures {
+    vector<Creature*> creatures;
+    vector<Creature*> enemies;
+  };
+  /** Returns the creatures seen by the given one, and which of them are its enemies. The relation is computed
+      for all pairs of creatures on the level at once at the start of a turn. Later in the turn only the pairs
+      involving a changed creature are recomputed, and the creatures near a changed square or light source
+      recompute what they see.*/
+  const VisibleCreatures& getVisibleCreatures(const Creature*) const;
+
+  /** Must be called when the creature's position, vision or visibility to others has changed.*/
+  void updateCreatureVisibility(Creature*);
+
   /** Checks whether the creature can see the square.*/
   bool canSee(const Creature* c, Vec2 to) const;
 
@@ -192,8 +205,8 @@ class Level {
   Model* getModel();
   Game* getGame() const;
 
-  void addLightSource(Vec2, double radius);
-  void removeLightSource(Vec2, double radius);
+  /** Called when the light emitted from the square may have changed. The light around it is recomputed lazily.*/
+  void updateLightSource(Vec2);
 
   /** Returns the amount of light in the square, capped within (0, 1).*/
   double getLight(Vec2) const;
@@ -204,6 +217,12 @@ class Level {
   /** Returns if two squares are connected assuming given movement.*/
   bool areConnected(Vec2, Vec2, const MovementType&) const;
 
+  /** Connectivity layer for the movement type. Sectors::contains(v) is equivalent to Square::canNavigate,
+    but doesn't touch the square. The instances are stored in a vector that grows when a new movement type
+    is seen or a square change splits an instance, so the reference is only valid until the next call
+    to getSectors or the next change of any square.*/
+  const Sectors& getSectors(const MovementType&) const;
+
   bool isChokePoint(Vec2, const MovementType&) const;
 
   void updateConnectivity(Vec2);
@@ -246,16 +265,49 @@ class Level {
   Vec2 SERIAL(backgroundOffset);
   Table<double> SERIAL(sunlight);
   HeapAllocated<CreatureBucketMap> SERIAL(bucketMap);
-  Table<double> SERIAL(lightAmount);
-  Table<double> SERIAL(lightCapAmount);
-  mutable unordered_map<MovementType, Sectors> SERIAL(sectors);
-  Sectors& getSectors(const MovementType&) const;
+  struct LightMap;
+  // Light and darkness aren't serialized, both are rebuilt from the squares and creatures on first use.
+  mutable unique_ptr<LightMap> light;
+  mutable unique_ptr<LightMap> darkness;
+  LightMap& getLightMap() const;
+  LightMap& getDarknessMap() const;
+  void updateLightMap(LightMap&, function<double(Vec2)> getRadius) const;
+  void markLightChanged(Vec2 pos);
+  // Movement types that can navigate the same squares share one Sectors instance. When a square changes in a way
+  // that affects only some of the types sharing it, they get split off into a copy.
+  mutable vector<Sectors> SERIAL(sectors);
+  mutable vector<vector<MovementType>> SERIAL(sectorsMembers);
+  mutable unordered_map<MovementType, int> sectorsIndex;
+  // XOR of a hash of every navigable square of each Sectors instance, kept up to date on every change. A new
+  // movement type is compared in full only against the instances with the same signature.
+  mutable vector<size_t> sectorsSignature;
+  mutable unordered_multimap<size_t, int> sectorsBySignature;
+  void addToSectors(int index, Vec2) const;
+  void removeFromSectors(int index, Vec2) const;
+  void setSectorsSignature(int index, size_t) const;
+  void initSectorsIndex();
+  mutable unordered_map<const Creature*, VisibleCreatures> visibleCreatures;
+  mutable optional<int> visibleCreaturesTurn;
+  mutable int visibleCreaturesRelations = 0;
+  // For every creature, the ones that have it in their VisibleCreatures.
+  mutable unordered_map<const Creature*, unordered_set<Creature*>> visibleCreaturesSeenBy;
+  // Creatures to recompute as observers and targets, and creatures to recompute only as observers. The lists
+  // keep the order of updates deterministic.
+  mutable unordered_set<Creature*> changedCreatures;
+  mutable vector<Creature*> changedCreaturesList;
+  mutable unordered_set<Creature*> changedObservers;
+  mutable vector<Creature*> changedObserversList;
+  void updateVisibleCreatures() const;
+  void updateVisibleCreatures(Creature*) const;
+  void updateVisibleCreaturesAsTarget(Creature*) const;
+  void updateVisibleEnemies() const;
+  void flushVisibleCreatures() const;
+  void invalidateVisibleCreatures(Vec2 pos, int radius) const;
+  void removeVisibleCreature(Creature*);
   
   friend class LevelBuilder;
   Level(SquareArray, Model*, vector<Location*>, const string& name, Table<double> sunlight, LevelId);
 
-  void addLightSource(Vec2 pos, double radius, int numLight);
-  void addDarknessSource(Vec2 pos, double radius, int numLight);
   FieldOfView& getFieldOfView(VisionId vision) const;
   vector<Vec2> getVisibleTilesNoDarkness(Vec2 pos, VisionId vision) const;
   bool isWithinVision(Vec2 from, Vec2 to, VisionId) const;
@@ -263,4 +315,6 @@ class Level {
   bool SERIAL(noDiagonalPassing) = false;
 };
 
+BOOST_CLASS_VERSION(Level, 2);
+
 #endif
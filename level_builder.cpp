@@ -12,7 +12,7 @@
 LevelBuilder::LevelBuilder(ProgressMeter* meter, RandomGen& r, int width, int height, const string& n, bool covered,
     optional<double> defaultLight)
   : squares(Rectangle(width, height)), background(width, height), unavailable(width, height, false),
-    heightMap(width, height, 0), coverOverride(width, height),
+    heightMap(width, height, 0), coverOverride(width, height), covered(width, height, false),
     sunlight(width, height, defaultLight ? *defaultLight : (covered ? 0.0 : 1.0)),
     allCovered(covered), attrib(width, height),
     type(width, height, SquareType(SquareId(0))), items(width, height), name(n), progressMeter(meter), random(r) {
@@ -43,8 +43,10 @@ const Square* LevelBuilder::getSquare(Vec2 pos) {
   return squares.getReadonly(transform(pos));
 }
 
-Square* LevelBuilder::modSquare(Vec2 pos) {
-  return squares.getSquare(transform(pos));
+Square* LevelBuilder::modSquare(Vec2 posT) {
+  Vec2 pos = transform(posT);
+  applyCover(pos);
+  return squares.getSquare(pos);
 }
    
 const SquareType& LevelBuilder::getType(Vec2 pos) {
@@ -60,20 +62,24 @@ void LevelBuilder::putSquare(Vec2 posT, SquareType t, vector<SquareAttrib> attr)
     progressMeter->addProgress();
   Vec2 pos = transform(posT);
   CHECK(type[pos].getId() != SquareId::STAIRS) << "Attempted to overwrite stairs";
-  bool wasCovered = false;
-  if (const Square* square = squares.getReadonly(pos)) {
-    wasCovered = square->isCovered();
-    if (auto backgroundObj = square->extractBackground())
+  if (const Square* square = squares.getReadonly(pos))
+    if (auto backgroundObj = square->extractBackground()) {
+      backgroundObj->setIndoors(covered[pos]);
       background[pos] = backgroundObj;
-  }
+    }
   squares.putSquare(pos, t);
   for (SquareAttrib at : attr)
     attrib[pos].insert(at);
   type[pos] = t;
   if (coverOverride[pos])
-    squares.getSquare(pos)->setCovered(*coverOverride[pos]);
-  else if (allCovered || wasCovered)
-    squares.getSquare(pos)->setCovered(true);
+    covered[pos] = *coverOverride[pos];
+  else
+    covered[pos] = allCovered || covered[pos] || squares.getReadonly(pos)->isCovered();
+}
+
+void LevelBuilder::applyCover(Vec2 pos) {
+  if (squares.getReadonly(pos)->isCovered() != covered[pos])
+    squares.getSquare(pos)->setCovered(covered[pos]);
 }
 
 Rectangle LevelBuilder::toGlobalCoordinates(Rectangle area) {
@@ -110,6 +116,7 @@ void LevelBuilder::putItems(Vec2 posT, vector<PItem> it) {
 
 bool LevelBuilder::canPutCreature(Vec2 posT, Creature* c) {
   Vec2 pos = transform(posT);
+  applyCover(pos);
   if (!squares.getReadonly(pos)->canEnter(c))
     return false;
   for (pair<PCreature, Vec2>& c : creatures) {
@@ -126,9 +133,11 @@ void LevelBuilder::setNoDiagonalPassing() {
 PLevel LevelBuilder::build(Model* m, LevelMaker* maker, LevelId levelId) {
   CHECK(mapStack.empty());
   maker->make(this, squares.getBounds());
-  for (Vec2 v : squares.getBounds())
+  for (Vec2 v : squares.getBounds()) {
+    applyCover(v);
     if (!items[v].empty())
       squares.getSquare(v)->dropItemsLevelGen(std::move(items[v]));
+  }
   PLevel l(new Level(std::move(squares), m, locations, name, sunlight, levelId));
   l->background = background;
   l->unavailable = unavailable;
@@ -188,8 +197,7 @@ Vec2 LevelBuilder::transform(Vec2 v) {
 void LevelBuilder::setCoverOverride(Vec2 posT, bool covered) {
   Vec2 pos = transform(posT);
   coverOverride[pos] = covered;
-  if (Square* square = squares.getSquare(pos))
-    square->setCovered(covered);
+  this->covered[pos] = covered;
 }
 
 void LevelBuilder::setSunlight(Vec2 pos, double s) {
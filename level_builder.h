@@ -47,7 +47,8 @@ class LevelBuilder {
   
   LevelBuilder(LevelBuilder&&) = default;
 
-  /** Returns a given square.*/
+  /** Returns a given square. Squares are shared between positions of the same type until modified,
+      so the cover state set by the builder is only applied when the level is built.*/
   const Square* getSquare(Vec2);
   Square* modSquare(Vec2);
 
@@ -71,8 +72,6 @@ class LevelBuilder {
   /** Puts a square on given position. Sets optional attributes of the square. The attributes remain if the square is changed.*/
   void putSquare(Vec2, SquareType, optional<SquareAttrib> = none);
   void putSquare(Vec2, SquareType, vector<SquareAttrib> attribs);
-  void putSquare(Vec2, PSquare, SquareType, optional<SquareAttrib> = none);
-  void putSquare(Vec2, PSquare, SquareType, vector<SquareAttrib> attribs);
   //@}
 
   /** Returns the square type.*/
@@ -118,6 +117,7 @@ class LevelBuilder {
   
   private:
   Vec2 transform(Vec2);
+  void applyCover(Vec2);
   SquareArray squares;
   Table<optional<ViewObject>> background;
   Table<bool> unavailable;
@@ -126,6 +126,7 @@ class LevelBuilder {
   vector<Location*> locations;
   vector<CollectiveBuilder*> collectives;
   Table<optional<bool>> coverOverride;
+  Table<bool> covered;
   Table<double> sunlight;
   bool allCovered;
   Table<EnumSet<SquareAttrib>> attrib;
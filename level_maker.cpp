@@ -228,11 +228,15 @@ class Connector : public LevelMaker {
     return diggingCost;
   }
 
-  void connect(LevelBuilder* builder, Vec2 p1, Vec2 p2, Rectangle area) {
-    ShortestPath path(area,
-        [builder, this, &area](Vec2 pos) { return getValue(builder, pos, area); }, 
-        [] (Vec2 v) { return v.length4(); },
-        Vec2::directions4(builder->getRandom()), p1 ,p2);
+  void updateValues(LevelBuilder* builder, Vec2 pos, Rectangle area, Table<double>& values) {
+    values[pos] = getValue(builder, pos, area);
+    for (Vec2 v : pos.neighbors8())
+      if (v.inRectangle(area))
+        values[v] = getValue(builder, v, area);
+  }
+
+  void connect(LevelBuilder* builder, Vec2 p1, Vec2 p2, Rectangle area, Table<double>& values) {
+    ShortestPath path(area, values, Vec2::directions4(builder->getRandom()), p1 ,p2);
     Vec2 prev(-100, -100);
     for (Vec2 v = p2; v != p1; v = path.getNextMove(v)) {
       if (!builder->getSquare(v)->canNavigate({MovementTrait::WALK})) {
@@ -258,6 +262,7 @@ class Connector : public LevelMaker {
         if (newType == SquareId::DOOR)
           builder->putSquare(v, SquareId::FLOOR);
         builder->putSquare(v, newType, setAttrib);
+        updateValues(builder, v, area, values);
       }
       if (builder->getType(v) == SquareId::FLOOR || 
           builder->getType(v) == SquareId::BRIDGE || 
@@ -274,11 +279,14 @@ class Connector : public LevelMaker {
     vector<Vec2> points = filter(area.getAllSquares(), [&] (Vec2 v) { return connectPred.apply(builder, v);});
     if (points.size() < 2)
       return;
+    Table<double> values(area);
+    for (Vec2 v : area)
+      values[v] = getValue(builder, v, area);
     for (int i : Range(30)) {
       p1 = builder->getRandom().choose(points);
       p2 = builder->getRandom().choose(points);
       if (p1 != p2)
-        connect(builder, p1, p2, area);
+        connect(builder, p1, p2, area, values);
     }
     auto dijkstraFun = [&] (Vec2 pos) {
       if (builder->getSquare(pos)->canEnterEmpty({MovementTrait::WALK}))
@@ -294,7 +302,7 @@ class Connector : public LevelMaker {
       bool found = false;
       for (Vec2 v : area)
         if (connectPred.apply(builder, v) && !connected[v]) {
-          connect(builder, p1, v, area);
+          connect(builder, p1, v, area, values);
           p1 = v;
           found = true;
           break;
@@ -1233,20 +1241,25 @@ class Roads : public LevelMaker {
         points.push_back(v);
         Debug() << "Connecting point " << v;
       }
+    Table<double> values(area);
+    for (Vec2 v : area)
+      values[v] = getValue(builder, v);
     for (int ind : Range(1, points.size())) {
       Vec2 p1 = points[ind];
       Vec2 p2 = points[ind - 1];
-      ShortestPath path(area,
-          [=](Vec2 pos) { return (pos == p1 || pos == p2) ? 1 : getValue(builder, pos); }, 
-          [] (Vec2 v) { return v.length4(); },
-          Vec2::directions4(builder->getRandom()), p1, p2);
+      values[p1] = values[p2] = 1;
+      ShortestPath path(area, values, Vec2::directions4(builder->getRandom()), p1, p2);
+      values[p1] = getValue(builder, p1);
+      values[p2] = getValue(builder, p2);
       Vec2 prev(-1, -1);
       for (Vec2 v = p2; v != p1; v = path.getNextMove(v)) {
         if (!path.isReachable(v))
           failGen();
         SquareType roadType = getRoadType(builder, v);
-        if (v != p2 && v != p1 && builder->getType(v) != roadType)
+        if (v != p2 && v != p1 && builder->getType(v) != roadType) {
           builder->putSquare(v, roadType);
+          values[v] = getValue(builder, v);
+        }
         prev = v;
       }
     }
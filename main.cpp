@@ -341,8 +341,10 @@ static int keeperMain(const variables_map& vars) {
     guiFactory.loadNonFreeImages(paidDataPath + "/images");
     soundLibrary = new SoundLibrary(&options, cAudio, paidDataPath + "/sound");
   }
-  if (tilesPresent)
+  if (tilesPresent) {
+    renderer.setTileCacheDir(userPath);
     initializeRendererTiles(renderer, paidDataPath + "/images");
+  }
   if (vars.count("replay")) {
     string fname = vars["replay"].as<string>();
     Debug() << "Reading from " << fname;
@@ -23,12 +23,17 @@
 #include "saved_game_info.h"
 #include "retired_games.h"
 #include "save_file_info.h"
+#include "save_file_index.h"
 
 MainLoop::MainLoop(View* v, Highscores* h, FileSharing* fSharing, const string& freePath,
     const string& uPath, Options* o, Jukebox* j, std::atomic<bool>& fin, bool singleThread,
     optional<GameTypeChoice> force)
       : view(v), dataFreePath(freePath), userPath(uPath), options(o), jukebox(j),
-        highscores(h), fileSharing(fSharing), finished(fin), useSingleThread(singleThread), forceGame(force) {
+        highscores(h), fileSharing(fSharing), finished(fin), useSingleThread(singleThread), forceGame(force),
+        saveFileIndex(uPath) {
+}
+
+MainLoop::~MainLoop() {
 }
 
 vector<SaveFileInfo> MainLoop::getSaveFiles(const string& path, const string& suffix) {
@@ -56,7 +61,7 @@ static string getDateString(time_t t) {
   return buf;
 }
 
-static const int saveVersion = 800;
+static const int saveVersion = 900;
 
 static bool isCompatible(int loadedVersion) {
   return loadedVersion > 2 && loadedVersion <= saveVersion && loadedVersion / 100 == saveVersion / 100;
@@ -136,7 +141,7 @@ static void saveMainModel(PGame& game, const string& path) {
 }
 
 int MainLoop::getSaveVersion(const SaveFileInfo& save) {
-  if (auto info = getNameAndVersion(userPath + "/" + save.filename))
+  if (auto info = saveFileIndex->getNameAndVersion(save.filename))
     return info->second;
   else
     return -1;
@@ -160,8 +165,12 @@ void MainLoop::uploadFile(const string& path, GameSaveType type) {
     view->presentText("Error uploading file", *error);
 }
 
+string MainLoop::getSaveFileName(PGame& game, GameSaveType gameType) {
+  return stripNonAscii(game->getGameIdentifier()) + getSaveSuffix(gameType);
+}
+
 string MainLoop::getSavePath(PGame& game, GameSaveType gameType) {
-  return userPath + "/" + stripNonAscii(game->getGameIdentifier()) + getSaveSuffix(gameType);
+  return userPath + "/" + getSaveFileName(game, gameType);
 }
 
 const int singleModelGameSaveTime = 100000;
@@ -188,6 +197,8 @@ void MainLoop::saveUI(PGame& game, GameSaveType type, SplashType splashType) {
         MEASURE(saveGame(game, path), "saving time")});
   Square::progressMeter = nullptr;
   Model::progressMeter = nullptr;
+  saveFileIndex->onSaved(getSaveFileName(game, type), game->getGameDisplayName(), saveVersion,
+      game->getSavedGameInfo());
   if (contains({GameSaveType::RETIRED_SINGLE, GameSaveType::RETIRED_SITE}, type))
     uploadFile(path, type);
 }
@@ -223,13 +234,14 @@ void MainLoop::getSaveOptions(const vector<FileSharing::GameInfo>& onlineGames,
       options.emplace_back(elem.second, ListElem::TITLE);
       append(options, transform2<ListElem>(files,
             [this, &onlineGames] (const SaveFileInfo& info) {
-              auto nameAndVersion = getNameAndVersion(userPath + "/" + info.filename);
+              auto nameAndVersion = saveFileIndex->getNameAndVersion(info.filename);
               for (auto& elem : onlineGames)
                 if (elem.filename == info.filename)
                   return ListElem(nameAndVersion->first, getGameDesc(elem));
               return ListElem(nameAndVersion->first, getDateString(info.date));}));
     }
   }
+  saveFileIndex->flush();
 }
 
 void MainLoop::getDownloadOptions(const vector<FileSharing::GameInfo>& games,
@@ -317,8 +329,9 @@ RetiredGames MainLoop::getRetiredGames() {
   RetiredGames ret;
   for (auto& info : getSaveFiles(userPath, getSaveSuffix(GameSaveType::RETIRED_SITE)))
     if (isCompatible(getSaveVersion(info)))
-      if (auto saved = getSavedGameInfo(userPath + "/" + info.filename))
+      if (auto saved = saveFileIndex->getSavedGameInfo(info.filename))
         ret.addLocal(*saved, info);
+  saveFileIndex->flush();
   optional<vector<FileSharing::SiteInfo>> onlineSites;
   doWithSplash(SplashType::SMALL, "Fetching list of retired dungeons from the server...",
       [&] { onlineSites = fileSharing->listSites(); }, [&] { fileSharing->cancel(); });
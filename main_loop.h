@@ -14,12 +14,14 @@ class Campaign;
 class Model;
 class RetiredGames;
 struct SaveFileInfo;
+class SaveFileIndex;
 class GameEvents;
 
 class MainLoop {
   public:
   MainLoop(View*, Highscores*, FileSharing*, const string& dataFreePath, const string& userPath,
       Options*, Jukebox*, std::atomic<bool>& finished, bool useSingleThread, optional<GameTypeChoice> forceGame);
+  ~MainLoop();
 
   void start(bool tilesPresent);
   void modelGenTest(int numTries, RandomGen&, Options*);
@@ -59,6 +61,7 @@ class MainLoop {
   PGame adventurerGame();
   PGame loadGame(string file, bool erase);
   PGame loadPrevious(bool erase);
+  string getSaveFileName(PGame&, GameSaveType);
   string getSavePath(PGame&, GameSaveType);
   void eraseAutosave(PGame&);
 
@@ -76,6 +79,7 @@ class MainLoop {
   std::atomic<bool>& finished;
   bool useSingleThread;
   optional<GameTypeChoice> forceGame;
+  HeapAllocated<SaveFileIndex> saveFileIndex;
 };
 
 
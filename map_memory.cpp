@@ -22,48 +22,149 @@
 
 template <class Archive> 
 void MapMemory::serialize(Archive& ar, const unsigned int version) {
-  ar & SVAR(table);
+  if (version == 0) {
+    // Older saves keep a full copy of the memory for every position.
+    HeapAllocated<PositionMap<optional<ViewIndex>>> table;
+    ar & SVAR(table);
+    map<LevelId, Rectangle> bounds;
+    table->forEach([&] (LevelId level, Vec2 pos, const optional<ViewIndex>& index) {
+      if (index) {
+        Rectangle r(pos, pos + Vec2(1, 1));
+        if (bounds.count(level))
+          r = Rectangle(min(r.left(), bounds.at(level).left()), min(r.top(), bounds.at(level).top()),
+              max(r.right(), bounds.at(level).right()), max(r.bottom(), bounds.at(level).bottom()));
+        bounds.erase(level);
+        bounds.insert(make_pair(level, r));
+      }
+    });
+    for (auto& elem : bounds)
+      tiles.insert(make_pair(elem.first, Table<int>(elem.second, 0)));
+    table->forEach([&] (LevelId level, Vec2 pos, const optional<ViewIndex>& index) {
+      if (index)
+        tiles.at(level)[pos] = addSnapshot(*index);
+    });
+  } else {
+    ar & SVAR(tiles) & SVAR(snapshots);
+    if (Archive::is_loading::value)
+      initSnapshotIndex();
+  }
 }
 
 SERIALIZABLE(MapMemory);
 
-MapMemory::MapMemory() {}
+MapMemory::MapMemory() : snapshots(1), refCount(1) {}
+
+void MapMemory::initSnapshotIndex() {
+  refCount = vector<int>(snapshots.size(), 0);
+  freeSnapshots.clear();
+  snapshotsByHash.clear();
+  for (auto& level : tiles)
+    for (Vec2 v : level.second.getBounds())
+      ++refCount[level.second[v]];
+  for (int i : Range(1, snapshots.size()))
+    if (snapshots[i])
+      snapshotsByHash[snapshots[i]->getHash()].push_back(i);
+    else
+      freeSnapshots.push_back(i);
+}
 
-void MapMemory::addObject(Position pos, const ViewObject& obj) {
+int MapMemory::addSnapshot(const ViewIndex& index) {
+  vector<int>& sameHash = snapshotsByHash[index.getHash()];
+  for (int i : sameHash)
+    if (*snapshots[i] == index) {
+      ++refCount[i];
+      return i;
+    }
+  int ret;
+  if (!freeSnapshots.empty()) {
+    ret = freeSnapshots.back();
+    freeSnapshots.pop_back();
+    snapshots[ret] = index;
+    refCount[ret] = 1;
+  } else {
+    ret = snapshots.size();
+    snapshots.push_back(index);
+    refCount.push_back(1);
+  }
+  sameHash.push_back(ret);
+  return ret;
+}
+
+void MapMemory::removeSnapshot(int index) {
+  if (index == 0 || --refCount[index] > 0)
+    return;
+  vector<int>& sameHash = snapshotsByHash.at(snapshots[index]->getHash());
+  removeElement(sameHash, index);
+  if (sameHash.empty())
+    snapshotsByHash.erase(snapshots[index]->getHash());
+  snapshots[index] = none;
+  freeSnapshots.push_back(index);
+}
+
+void MapMemory::setSnapshot(Position pos, int index) {
   CHECK(pos.isValid());
-  if (!getViewIndex(pos))
-    getViewIndex(pos) = ViewIndex();
-  getViewIndex(pos)->insert(obj);
-  getViewIndex(pos)->setHighlight(HighlightType::MEMORY);
-  updateUpdated(pos);
+  const Level* level = pos.getLevel();
+  LevelId levelId = level->getUniqueId();
+  if (!tiles.count(levelId))
+    tiles.insert(make_pair(levelId, Table<int>(level->getBounds(), 0)));
+  else if (!pos.getCoord().inRectangle(tiles.at(levelId).getBounds())) {
+    // Memory loaded from an older save only covers the remembered part of the level.
+    Table<int> levelTiles(level->getBounds(), 0);
+    for (Vec2 v : tiles.at(levelId).getBounds())
+      levelTiles[v] = tiles.at(levelId)[v];
+    tiles.at(levelId) = std::move(levelTiles);
+  }
+  int& tile = tiles.at(levelId)[pos.getCoord()];
+  if (tile == index) {
+    removeSnapshot(index);
+    return;
+  }
+  removeSnapshot(tile);
+  tile = index;
+  if (!updated.count(levelId))
+    updated.insert(make_pair(levelId, UpdatedTiles{Table<bool>(level->getBounds(), false), {}}));
+  UpdatedTiles& levelUpdated = updated.at(levelId);
+  if (!levelUpdated.mask[pos.getCoord()]) {
+    levelUpdated.mask[pos.getCoord()] = true;
+    levelUpdated.positions.push_back(pos);
+  }
 }
 
-optional<ViewIndex>& MapMemory::getViewIndex(Position pos) {
-  return table->getOrInit(pos);
+void MapMemory::addObject(Position pos, const ViewObject& obj) {
+  CHECK(pos.isValid());
+  ViewIndex index = getViewIndex(pos).get_value_or(ViewIndex());
+  index.insert(obj);
+  index.setHighlight(HighlightType::MEMORY);
+  setSnapshot(pos, addSnapshot(index));
 }
 
 const optional<ViewIndex>& MapMemory::getViewIndex(Position pos) const {
-  return table->get(pos);
+  auto it = tiles.find(pos.getLevel()->getUniqueId());
+  if (it == tiles.end() || !pos.getCoord().inRectangle(it->second.getBounds()))
+    return snapshots[0];
+  return snapshots[it->second[pos.getCoord()]];
 }
 
-void MapMemory::update(Position pos, const ViewIndex& index1) {
-  CHECK(pos.isValid());
-  auto& index = getViewIndex(pos); 
-  index = index1;
-  index->setHighlight(HighlightType::MEMORY);
-  if (index->hasObject(ViewLayer::CREATURE) && 
-      !index->getObject(ViewLayer::CREATURE).hasModifier(ViewObjectModifier::REMEMBER))
-    index->removeObject(ViewLayer::CREATURE);
-  updateUpdated(pos);
+int MapMemory::getNumSharing(Position pos) const {
+  auto it = tiles.find(pos.getLevel()->getUniqueId());
+  if (it == tiles.end() || !pos.getCoord().inRectangle(it->second.getBounds()))
+    return 0;
+  int index = it->second[pos.getCoord()];
+  return index == 0 ? 0 : refCount[index];
 }
 
-void MapMemory::updateUpdated(Position pos) {
-  if (pos.isValid())
-    updated[pos.getLevel()->getUniqueId()].insert(pos);
+void MapMemory::update(Position pos, const ViewIndex& index1) {
+  CHECK(pos.isValid());
+  ViewIndex index = index1;
+  index.setHighlight(HighlightType::MEMORY);
+  if (index.hasObject(ViewLayer::CREATURE) && 
+      !index.getObject(ViewLayer::CREATURE).hasModifier(ViewObjectModifier::REMEMBER))
+    index.removeObject(ViewLayer::CREATURE);
+  setSnapshot(pos, addSnapshot(index));
 }
 
 void MapMemory::clearSquare(Position pos) {
-  getViewIndex(pos) = none;
+  setSnapshot(pos, 0);
 }
 
 const MapMemory& MapMemory::empty() {
@@ -71,10 +172,19 @@ const MapMemory& MapMemory::empty() {
   return mem;
 } 
 
-const unordered_set<Position, CustomHash<Position>>& MapMemory::getUpdated(const Level* level) const {
-  return updated[level->getUniqueId()];
+const vector<Position>& MapMemory::getUpdated(const Level* level) const {
+  static const vector<Position> noUpdates;
+  auto it = updated.find(level->getUniqueId());
+  if (it == updated.end())
+    return noUpdates;
+  return it->second.positions;
 }
 
 void MapMemory::clearUpdated(const Level* level) const {
-  updated[level->getUniqueId()].clear();
+  auto it = updated.find(level->getUniqueId());
+  if (it != updated.end()) {
+    for (Position pos : it->second.positions)
+      it->second.mask[pos.getCoord()] = false;
+    it->second.positions.clear();
+  }
 }
@@ -28,20 +28,37 @@ class MapMemory {
   MapMemory();
   void addObject(Position, const ViewObject&);
   void update(Position, const ViewIndex&);
-  const unordered_set<Position, CustomHash<Position>>& getUpdated(const Level*) const;
+  const vector<Position>& getUpdated(const Level*) const;
   void clearUpdated(const Level*) const;
   void clearSquare(Position pos);
   static const MapMemory& empty();
   const optional<ViewIndex>& getViewIndex(Position) const;
+  /** Returns the number of positions that share the remembered tile at the given position.*/
+  int getNumSharing(Position) const;
 
   template <class Archive> 
   void serialize(Archive& ar, const unsigned int version);
 
   private:
-  void updateUpdated(Position);
-  optional<ViewIndex>& getViewIndex(Position);
-  HeapAllocated<PositionMap<optional<ViewIndex>>> SERIAL(table);
-  mutable map<int, unordered_set<Position, CustomHash<Position>>> updated;
+  void setSnapshot(Position, int index);
+  int addSnapshot(const ViewIndex&);
+  void removeSnapshot(int index);
+  void initSnapshotIndex();
+  // Each level has a dense grid of indices into the table of distinct remembered tiles. Index 0 is the empty
+  // memory. Large parts of a map look the same (floor, walls, water), so identical tiles share a single copy,
+  // and a modified tile gets a new (or another matching) entry instead of changing the shared one.
+  map<LevelId, Table<int>> SERIAL(tiles);
+  vector<optional<ViewIndex>> SERIAL(snapshots);
+  vector<int> refCount;
+  vector<int> freeSnapshots;
+  unordered_map<size_t, vector<int>> snapshotsByHash;
+  struct UpdatedTiles {
+    Table<bool> mask;
+    vector<Position> positions;
+  };
+  mutable map<LevelId, UpdatedTiles> updated;
 };
 
+BOOST_CLASS_VERSION(MapMemory, 1);
+
 #endif
@@ -25,15 +25,19 @@
 #include <SDL2/SDL.h>
 
 void MinimapGui::renderMap(Renderer& renderer, Rectangle target) {
-  if (!mapBufferTex)
-    mapBufferTex.emplace(mapBuffer);
-  else
-    mapBufferTex->loadFrom(mapBuffer);
-  renderer.drawImage(target, info.bounds, *mapBufferTex);
+  if (!currentLevel)
+    return;
+  LevelMap& levelMap = levelMaps.at(currentLevel);
+  if (!levelMap.texture)
+    levelMap.texture.emplace(levelMap.buffer);
+  else if (levelMap.dirty)
+    levelMap.texture->loadFrom(levelMap.buffer, *levelMap.dirty);
+  levelMap.dirty = none;
+  renderer.drawImage(target, info.bounds, *levelMap.texture);
   Vec2 topLeft = target.topLeft();
   double scale = min(double(target.width()) / info.bounds.width(),
       double(target.width()) / info.bounds.height());
-  for (Vec2 v : info.roads) {
+  for (Vec2 v : levelMap.roads) {
     Vec2 rrad(1, 1);
     Vec2 pos = topLeft + (v - info.bounds.topLeft()) * scale;
     if (pos.inRectangle(target.minusMargin(rrad.x)))
@@ -65,11 +69,18 @@ void MinimapGui::render(Renderer& r) {
 }
 
 MinimapGui::MinimapGui(Renderer& r, function<void()> f) : clickFun(f), renderer(r) {
-  mapBuffer = Renderer::createSurface(Level::getMaxBounds().width(), Level::getMaxBounds().height());
+}
+
+MinimapGui::~MinimapGui() {
+  clear();
 }
 
 void MinimapGui::clear() {
+  for (auto& elem : levelMaps)
+    SDL_FreeSurface(elem.second.buffer);
+  levelMaps.clear();
   currentLevel = nullptr;
+  currentMemory = nullptr;
   info = MinimapInfo {};
 }
 
@@ -81,29 +92,57 @@ bool MinimapGui::onLeftClick(Vec2 v) {
   return false;
 }
 
+void MinimapGui::updatePixel(LevelMap& levelMap, Position v) {
+  CHECK(v.getCoord().inRectangle(Vec2(levelMap.buffer->w, levelMap.buffer->h))) << v.getCoord();
+  Renderer::putPixel(levelMap.buffer, v.getCoord(), Tile::getColor(v.getViewObject()));
+  Vec2 pos = v.getCoord();
+  if (!levelMap.dirty)
+    levelMap.dirty = Rectangle(pos, pos + Vec2(1, 1));
+  else
+    levelMap.dirty = Rectangle(min(levelMap.dirty->left(), pos.x), min(levelMap.dirty->top(), pos.y),
+        max(levelMap.dirty->right(), pos.x + 1), max(levelMap.dirty->bottom(), pos.y + 1));
+  if (v.getViewObject().hasModifier(ViewObject::Modifier::ROAD))
+    levelMap.roads.insert(v.getCoord());
+}
+
+MinimapGui::LevelMap& MinimapGui::getLevelMap(const Level* level, const MapMemory& memory) {
+  if (currentMemory != &memory) {
+    clear();
+    currentMemory = &memory;
+  }
+  auto it = levelMaps.find(level);
+  if (it == levelMaps.end()) {
+    LevelMap& levelMap = levelMaps[level];
+    levelMap.buffer = Renderer::createSurface(Level::getMaxBounds().width(), Level::getMaxBounds().height());
+    int col = SDL_MapRGBA(levelMap.buffer->format, 0, 0, 0, 1);
+    SDL_FillRect(levelMap.buffer, nullptr, col);
+    for (Position v : level->getAllPositions())
+      if (memory.getViewIndex(v))
+        updatePixel(levelMap, v);
+    for (const Location* loc : level->getAllLocations())
+      for (Position v : loc->getAllSquares())
+        if (memory.getViewIndex(v)) {
+          levelMap.seenLocations.insert(loc);
+          break;
+        }
+    // The texture is created from the whole buffer on first render.
+    levelMap.dirty = none;
+    return levelMap;
+  }
+  return it->second;
+}
+
 void MinimapGui::update(const Level* level, Rectangle bounds, const CreatureView* creature, bool printLocations) {
   info.bounds = bounds;
   info.enemies.clear();
   info.locations.clear();
   const MapMemory& memory = creature->getMemory();
-  if (currentLevel != level) {
-    int col = SDL_MapRGBA(mapBuffer->format, 0, 0, 0, 1);
-    SDL_FillRect(mapBuffer, nullptr, col);
-    info.roads.clear();
-    for (Position v : level->getAllPositions()) {
-      if (memory.getViewIndex(v)) {
-        Renderer::putPixel(mapBuffer, v.getCoord(), Tile::getColor(v.getViewObject()));
-        if (v.getViewObject().hasModifier(ViewObject::Modifier::ROAD))
-          info.roads.insert(v.getCoord());
-      }
-    }
-    currentLevel = level;
-  }
+  LevelMap& levelMap = getLevelMap(level, memory);
+  currentLevel = level;
   for (Position v : memory.getUpdated(level)) {
-    CHECK(v.getCoord().inRectangle(Vec2(mapBuffer->w, mapBuffer->h))) << v.getCoord();
-    Renderer::putPixel(mapBuffer, v.getCoord(), Tile::getColor(v.getViewObject()));
-    if (v.getViewObject().hasModifier(ViewObject::Modifier::ROAD))
-      info.roads.insert(v.getCoord());
+    updatePixel(levelMap, v);
+    if (const Location* loc = v.getLocation())
+      levelMap.seenLocations.insert(loc);
   }
   memory.clearUpdated(level);
   info.player = creature->getPosition();
@@ -112,12 +151,7 @@ void MinimapGui::update(const Level* level, Rectangle bounds, const CreatureView
       info.enemies.push_back(pos);
   if (printLocations)
     for (const Location* loc : level->getAllLocations()) {
-      bool seen = false;
-      for (Position v : loc->getAllSquares())
-        if (memory.getViewIndex(v)) {
-          seen = true;
-          break;
-        }
+      bool seen = levelMap.seenLocations.count(loc);
       if (loc->isMarkedAsSurprise() && !seen)
         info.locations.push_back({loc->getMiddle().getCoord(), ""});
       if (loc->getName() && seen) {
@@ -22,11 +22,15 @@
 class Level;
 class CreatureView;
 class Renderer;
+class MapMemory;
+class Location;
+class Position;
 
 class MinimapGui : public GuiElem {
   public:
 
   MinimapGui(Renderer&, function<void()> clickFun);
+  ~MinimapGui();
 
   void update(const Level* level, Rectangle bounds, const CreatureView* creature, bool printLocations = false);
   void presentMap(const CreatureView*, Rectangle bounds, Renderer&, function<void(double, double)> clickFun);
@@ -38,11 +42,20 @@ class MinimapGui : public GuiElem {
   private:
 
   void renderMap(Renderer&, Rectangle target);
-  void putMapPixel(Vec2 pos, Color col);
+
+  // Kept for every level that has been shown, so that switching levels only applies the memory updates.
+  struct LevelMap {
+    SDL_Surface* buffer;
+    optional<Texture> texture;
+    optional<Rectangle> dirty;
+    unordered_set<Vec2, CustomHash<Vec2>> roads;
+    unordered_set<const Location*> seenLocations;
+  };
+  LevelMap& getLevelMap(const Level*, const MapMemory&);
+  void updatePixel(LevelMap&, Position);
 
   struct MinimapInfo {
     Rectangle bounds;
-    unordered_set<Vec2, CustomHash<Vec2>> roads;
     vector<Vec2> enemies;
     Vec2 player;
     struct Location {
@@ -54,8 +67,8 @@ class MinimapGui : public GuiElem {
 
   function<void()> clickFun;
 
-  SDL_Surface* mapBuffer;
-  optional<Texture> mapBufferTex;
+  map<const Level*, LevelMap> levelMaps;
+  const MapMemory* currentMemory = nullptr;
   const Level* currentLevel = nullptr;
   Renderer& renderer;
 };
@@ -1177,15 +1177,14 @@ void PlayerControl::initialize() {
     onMoved(c);
 }
 
+// Only called for the collective's own creatures, since the collective subscribes to them while they are members.
 void PlayerControl::onMoved(Creature* c) {
-  if (contains(getCreatures(), c)) {
-    vector<Position> visibleTiles = c->getVisibleTiles();
-    visibilityMap->update(c, visibleTiles);
-    for (Position pos : visibleTiles) {
-      if (getCollective()->addKnownTile(pos))
-        updateKnownLocations(pos);
-      addToMemory(pos);
-    }
+  vector<Position> visibleTiles = c->getVisibleTiles();
+  visibilityMap->update(c, visibleTiles);
+  for (Position pos : visibleTiles) {
+    if (getCollective()->addKnownTile(pos))
+      updateKnownLocations(pos);
+    addToMemory(pos);
   }
 }
 
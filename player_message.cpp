@@ -72,7 +72,7 @@ bool PlayerMessage::isClickable() const {
 }
 
 int PlayerMessage::getHash() const {
-  return combineHash(text, priority, freshness);
+  return combineHash(getUniqueId(), text, priority, freshness, isClickable());
 }
 
 template <class Archive> 
@@ -86,6 +86,16 @@ void PositionMap<T>::limitToModel(const Model* m) {
       outliers.erase(elem.first);
 }
 
+template <class T>
+void PositionMap<T>::forEach(function<void(LevelId, Vec2, const T&)> fun) const {
+  for (auto& elem : tables)
+    for (Vec2 v : elem.second.getBounds())
+      fun(elem.first, v, elem.second[v]);
+  for (auto& elem : outliers)
+    for (auto& outlier : elem.second)
+      fun(elem.first, outlier.first, outlier.second);
+}
+
 template <class T>
 template <class Archive> 
 void PositionMap<T>::serialize(Archive& ar, const unsigned int version) {
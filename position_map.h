@@ -16,6 +16,8 @@ class PositionMap {
   T& getOrFail(Position);
   void set(Position, const T&);
   void limitToModel(const Model*);
+  /** Visits every stored element, including ones equal to the default value.*/
+  void forEach(function<void(LevelId, Vec2, const T&)>) const;
 
   template <class Archive> 
   void serialize(Archive& ar, const unsigned int version);
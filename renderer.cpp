@@ -18,6 +18,7 @@
 #include "view_object.h"
 #include "tile.h"
 #include "dirent.h"
+#include <sys/stat.h>
 
 #include "fontstash.h"
 
@@ -115,6 +116,20 @@ Texture::~Texture() {
 
 static int totalTex = 0;
 
+static int getTextureMode(SDL_Surface* image) {
+  if (image->format->BytesPerPixel == 4) {
+    if (image->format->Rmask == 0x000000ff)
+      return GL_RGBA;
+    else
+      return GL_BGRA;
+  } else {
+    if (image->format->Rmask == 0x000000ff)
+      return GL_RGB;
+    else
+      return GL_BGR;
+  }
+}
+
 void Texture::loadFrom(SDL_Surface* image) {
   if (!texId) {
     texId = 0;
@@ -129,18 +144,7 @@ void Texture::loadFrom(SDL_Surface* image) {
   glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
   glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
   checkOpenglError();
-  int mode = GL_RGB;
-  if (image->format->BytesPerPixel == 4) {
-    if (image->format->Rmask == 0x000000ff)
-      mode = GL_RGBA;
-    else
-      mode = GL_BGRA;
-  } else {
-    if (image->format->Rmask == 0x000000ff)
-      mode = GL_RGB;
-    else
-      mode = GL_BGR;
-  }
+  int mode = getTextureMode(image);
   glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
   glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
   glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
@@ -151,6 +155,29 @@ void Texture::loadFrom(SDL_Surface* image) {
   size = Vec2(image->w, image->h);
 }
 
+void Texture::loadFrom(SDL_Surface* image, Rectangle area) {
+  if (!texId || size != Vec2(image->w, image->h)) {
+    loadFrom(image);
+    return;
+  }
+  if (!area.intersects(Rectangle(size)))
+    return;
+  area = area.intersection(Rectangle(size));
+  glBindTexture(GL_TEXTURE_2D, (*texId));
+  checkOpenglError();
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  glPixelStorei(GL_UNPACK_ROW_LENGTH, image->w);
+  glPixelStorei(GL_UNPACK_SKIP_PIXELS, area.left());
+  glPixelStorei(GL_UNPACK_SKIP_ROWS, area.top());
+  checkOpenglError();
+  glTexSubImage2D(GL_TEXTURE_2D, 0, area.left(), area.top(), area.width(), area.height(),
+      getTextureMode(image), GL_UNSIGNED_BYTE, image->pixels);
+  glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+  glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+  glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
+  checkOpenglError();
+}
+
 Texture::Texture(const string& path, int px, int py, int w, int h) {
   SDL_Surface* image = IMG_Load(path.c_str());
   CHECK(image) << IMG_GetError();
@@ -196,36 +223,6 @@ const Vec2& Texture::getSize() const {
   return size;
 }
 
-void Texture::addTexCoord(int x, int y) const {
-  glTexCoord2f((float)x / size.x, (float)y / size.y);
-}
-
-void Texture::render(Vec2 a, Vec2 b, Vec2 p, Vec2 k, optional<Color> color, bool vFlip, bool hFlip) const {
-  if (vFlip)
-    swap(p.y, k.y);
-  if (hFlip)
-    swap(p.x, k.x);
-  glBindTexture(GL_TEXTURE_2D, (*texId));
-  checkOpenglError();
-  glEnable(GL_TEXTURE_2D);
-  glBegin(GL_QUADS);
-  if (color)
-    color->applyGl();
-  else
-    glColor3f(1, 1, 1);
-  addTexCoord(p.x, p.y);
-  glVertex2f(a.x, a.y);
-  addTexCoord(k.x, p.y);
-  glVertex2f(b.x, a.y);
-  addTexCoord(k.x, k.y);
-  glVertex2f(b.x, b.y);
-  addTexCoord(p.x, k.y);
-  glVertex2f(a.x, b.y);
-  glEnd();
-  glDisable(GL_TEXTURE_2D);
-  checkOpenglError();
-}
-
 static float sizeConv(int size) {
   return 1.15 * (float)size;
 }
@@ -234,13 +231,35 @@ int Renderer::getTextLength(const string& s, int size, FontId font) {
   return getTextSize(s, size, font).x;
 }
 
+const int maxTextSizeCache = 3000;
+
 Vec2 Renderer::getTextSize(const string& s, int size, FontId id) {
-  float minx, maxx, miny, maxy;
   int font = getFont(id);
+  std::lock_guard<std::mutex> lock(textSizeMutex);
+  TextSizeCache& cache = textSizeCache[make_pair(font, size)];
+  auto cached = cache.index.find(s);
+  if (cached != cache.index.end()) {
+    ++textCacheHits;
+    cache.entries.splice(cache.entries.begin(), cache.entries, cached->second);
+    return cached->second->second;
+  }
+  ++textCacheMisses;
+  float minx, maxx, miny, maxy;
   sth_dim_text(fontStash, font, sizeConv(size), s.c_str(), &minx, &miny, &maxx, &maxy);
   float height;
   sth_vmetrics(fontStash, font, sizeConv(size), nullptr, nullptr, &height);
-  return Vec2(maxx - minx, height);
+  if (cache.entries.size() >= maxTextSizeCache) {
+    cache.index.erase(cache.entries.back().first);
+    cache.entries.pop_back();
+  }
+  Vec2 ret(maxx - minx, height);
+  cache.entries.push_front(make_pair(s, ret));
+  cache.index[s] = cache.entries.begin();
+  return ret;
+}
+
+Renderer::TextCacheStats Renderer::getTextCacheStats() const {
+  return {textCacheHits, textCacheMisses};
 }
 
 int Renderer::getFont(Renderer::FontId id) {
@@ -254,30 +273,41 @@ int Renderer::getFont(Renderer::FontId id) {
 }
 
 void Renderer::drawText(FontId id, int size, Color color, int x, int y, const string& s, CenterType center) {
-  if (!s.empty())
-    addRenderElem([this, s, center, size, color, x, y, id] {
-        int ox = 0;
-        int oy = 0;
-        Vec2 dim = getTextSize(s, size, id);
-        switch (center) {
-          case HOR:
-            ox -= dim.x / 2;
-            break;
-          case VER:
-            oy -= dim.y / 2;
-            break;
-          case HOR_VER:
-            ox -= dim.x / 2;
-            oy -= dim.y / 2;
-            break;
-          default:
-            break;
-        }
-        sth_begin_draw(fontStash);
-        color.applyGl();
-        sth_draw_text(fontStash, getFont(id), sizeConv(size), ox + x, oy + y + (dim.y * 0.9), s.c_str(), nullptr);
-        sth_end_draw(fontStash);
-    });
+  if (!s.empty()) {
+    RenderCommand& command = addRenderCommand(RenderCommand::TEXT, Vec2(x, y), Vec2(x, y), color);
+    command.font = id;
+    command.size = size;
+    command.center = center;
+    vector<char>& text = textBuffer[currentLayer];
+    command.textOffset = text.size();
+    text.insert(text.end(), s.begin(), s.end());
+    text.push_back(0);
+  }
+}
+
+void Renderer::renderText(const RenderCommand& command, const char* s) {
+  int ox = 0;
+  int oy = 0;
+  Vec2 dim = getTextSize(s, command.size, command.font);
+  switch (command.center) {
+    case HOR:
+      ox -= dim.x / 2;
+      break;
+    case VER:
+      oy -= dim.y / 2;
+      break;
+    case HOR_VER:
+      ox -= dim.x / 2;
+      oy -= dim.y / 2;
+      break;
+    default:
+      break;
+  }
+  sth_begin_draw(fontStash);
+  command.color.applyGl();
+  sth_draw_text(fontStash, getFont(command.font), sizeConv(command.size), ox + command.pos[0],
+      oy + command.pos[1] + (dim.y * 0.9), s, nullptr);
+  sth_end_draw(fontStash);
 }
 
 void Renderer::drawText(Color color, int x, int y, const char* c, CenterType center, int size) {
@@ -301,9 +331,7 @@ void Renderer::drawTextWithHotkey(Color color, int x, int y, const string& text,
 
 void Renderer::drawImage(int px, int py, const Texture& image, double scale, optional<Color> color) {
   Vec2 p(px, py);
-  addRenderElem([this, p, &image, scale, color] {
-    image.render(p, p + image.getSize() * scale, Vec2(0, 0), image.getSize(), color);
-  });
+  addTexturedQuad(image, p, p + image.getSize() * scale, Vec2(0, 0), image.getSize(), color, false, false);
 }
 
 void Renderer::drawImage(Rectangle target, Rectangle source, const Texture& image) {
@@ -316,38 +344,18 @@ void Renderer::drawSprite(Vec2 pos, Vec2 stretchSize, const Texture& t) {
 
 void Renderer::drawSprite(Vec2 pos, Vec2 source, Vec2 size, const Texture& t, optional<Vec2> targetSize,
     optional<Color> color, bool vFlip, bool hFlip) {
-  addRenderElem([this, &t, pos, source, size, targetSize, color, vFlip, hFlip] {
-      if (targetSize)
-        t.render(pos, pos + *targetSize, source, source + size, color, vFlip, hFlip);
-      else
-        t.render(pos, pos + size, source, source + size, color, vFlip, hFlip);
-  });
+  addTexturedQuad(t, pos, pos + (targetSize ? *targetSize : size), source, source + size, color, vFlip, hFlip);
 }
 
 void Renderer::drawFilledRectangle(const Rectangle& t, Color color, optional<Color> outline) {
-  addRenderElem([this, t, color, outline] {
-    Vec2 a = t.topLeft();
-    Vec2 b = t.bottomRight();
-    if (outline) {
-      glLineWidth(2);
-      glBegin(GL_LINE_LOOP);
-      outline->applyGl();
-      glVertex2f(a.x, a.y);
-      glVertex2f(b.x, a.y);
-      glVertex2f(b.x, b.y);
-      glVertex2f(a.x, b.y);
-      glEnd();
-      a += Vec2(2, 2);
-      b -= Vec2(2, 2);
-    }
-    glBegin(GL_QUADS);
-    color.applyGl();
-    glVertex2f(a.x, a.y);
-    glVertex2f(b.x, a.y);
-    glVertex2f(b.x, b.y);
-    glVertex2f(a.x, b.y);
-    glEnd();
-  });
+  Vec2 a = t.topLeft();
+  Vec2 b = t.bottomRight();
+  if (outline) {
+    addRenderCommand(RenderCommand::OUTLINE, a, b, *outline);
+    a += Vec2(2, 2);
+    b -= Vec2(2, 2);
+  }
+  addRenderCommand(RenderCommand::QUAD, a, b, color);
 }
 
 void Renderer::drawFilledRectangle(int px, int py, int kx, int ky, Color color, optional<Color> outline) {
@@ -382,10 +390,133 @@ void Renderer::setGlScissor(optional<Rectangle> s) {
   }
 }
 
-void Renderer::addRenderElem(function<void()> f) {
-  optional<Rectangle> thisScissor = scissor;
-  f = [f, thisScissor, this] { setGlScissor(thisScissor); f(); };
-  renderList[currentLayer].push_back(f);
+optional<Rectangle> Renderer::RenderCommand::getScissor() const {
+  if (hasScissor)
+    return Rectangle(scissor[0], scissor[1], scissor[2], scissor[3]);
+  else
+    return none;
+}
+
+bool Renderer::RenderCommand::canBatchWith(const RenderCommand& o) const {
+  return type == o.type && type != TEXT && (type != TEXTURED_QUAD || texture == o.texture)
+      && getScissor() == o.getScissor();
+}
+
+Renderer::RenderCommand& Renderer::addRenderCommand(RenderCommand::Type type, Vec2 a, Vec2 b, Color color) {
+  renderList[currentLayer].emplace_back();
+  RenderCommand& ret = renderList[currentLayer].back();
+  ret.type = type;
+  ret.pos[0] = a.x;
+  ret.pos[1] = a.y;
+  ret.pos[2] = b.x;
+  ret.pos[3] = b.y;
+  ret.color = color;
+  ret.hasScissor = !!scissor;
+  if (scissor) {
+    ret.scissor[0] = scissor->left();
+    ret.scissor[1] = scissor->top();
+    ret.scissor[2] = scissor->right();
+    ret.scissor[3] = scissor->bottom();
+  }
+  return ret;
+}
+
+void Renderer::addTexturedQuad(const Texture& t, Vec2 a, Vec2 b, Vec2 p, Vec2 k, optional<Color> color,
+    bool vFlip, bool hFlip) {
+  if (vFlip)
+    swap(p.y, k.y);
+  if (hFlip)
+    swap(p.x, k.x);
+  RenderCommand& command = addRenderCommand(RenderCommand::TEXTURED_QUAD, a, b,
+      color ? *color : colors[ColorId::WHITE]);
+  command.texture = *t.texId;
+  command.texCoord[0] = (float)p.x / t.size.x;
+  command.texCoord[1] = (float)p.y / t.size.y;
+  command.texCoord[2] = (float)k.x / t.size.x;
+  command.texCoord[3] = (float)k.y / t.size.y;
+}
+
+void Renderer::renderBatch(const RenderCommand* begin, const RenderCommand* end) {
+  vertexArray.clear();
+  texCoordArray.clear();
+  colorArray.clear();
+  auto addVertex = [&] (const RenderCommand& c, int x, int y) {
+    vertexArray.push_back(c.pos[x]);
+    vertexArray.push_back(c.pos[y]);
+    if (c.type == RenderCommand::TEXTURED_QUAD) {
+      texCoordArray.push_back(c.texCoord[x]);
+      texCoordArray.push_back(c.texCoord[y]);
+    }
+    colorArray.push_back(c.color.r);
+    colorArray.push_back(c.color.g);
+    colorArray.push_back(c.color.b);
+    colorArray.push_back(c.color.a);
+  };
+  for (const RenderCommand* c = begin; c != end; ++c)
+    if (c->type == RenderCommand::OUTLINE) {
+      addVertex(*c, 0, 1); addVertex(*c, 2, 1);
+      addVertex(*c, 2, 1); addVertex(*c, 2, 3);
+      addVertex(*c, 2, 3); addVertex(*c, 0, 3);
+      addVertex(*c, 0, 3); addVertex(*c, 0, 1);
+    } else {
+      addVertex(*c, 0, 1);
+      addVertex(*c, 2, 1);
+      addVertex(*c, 2, 3);
+      addVertex(*c, 0, 3);
+    }
+  bool textured = begin->type == RenderCommand::TEXTURED_QUAD;
+  glEnableClientState(GL_VERTEX_ARRAY);
+  glEnableClientState(GL_COLOR_ARRAY);
+  glVertexPointer(2, GL_FLOAT, 0, vertexArray.data());
+  glColorPointer(4, GL_UNSIGNED_BYTE, 0, colorArray.data());
+  if (textured) {
+    glBindTexture(GL_TEXTURE_2D, begin->texture);
+    ++frameStats.numStateChanges;
+    glEnable(GL_TEXTURE_2D);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glTexCoordPointer(2, GL_FLOAT, 0, texCoordArray.data());
+  } else
+    glDisable(GL_TEXTURE_2D);
+  if (begin->type == RenderCommand::OUTLINE) {
+    glLineWidth(2);
+    glDrawArrays(GL_LINES, 0, vertexArray.size() / 2);
+  } else
+    glDrawArrays(GL_QUADS, 0, vertexArray.size() / 2);
+  if (textured) {
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisable(GL_TEXTURE_2D);
+  }
+  glDisableClientState(GL_COLOR_ARRAY);
+  glDisableClientState(GL_VERTEX_ARRAY);
+  checkOpenglError();
+  ++frameStats.numBatches;
+}
+
+void Renderer::renderCommands(const vector<RenderCommand>& commands, const vector<char>& text) {
+  for (int i = 0; i < commands.size();) {
+    const RenderCommand& first = commands[i];
+    optional<Rectangle> thisScissor = first.getScissor();
+    if (thisScissor != scissor)
+      ++frameStats.numStateChanges;
+    setGlScissor(thisScissor);
+    if (first.type == RenderCommand::TEXT) {
+      renderText(first, &text[first.textOffset]);
+      ++frameStats.numBatches;
+      ++i;
+      continue;
+    }
+    int end = i + 1;
+    while (end < commands.size() && first.canBatchWith(commands[end]))
+      ++end;
+    renderBatch(&commands[i], &commands[0] + end);
+    i = end;
+  }
+  frameStats.numCommands += commands.size();
+  frameStats.numBytes += commands.size() * sizeof(RenderCommand) + text.size();
+}
+
+const Renderer::FrameStats& Renderer::getFrameStats() const {
+  return lastFrameStats;
 }
 
 void Renderer::setTopLayer() {
@@ -593,6 +724,74 @@ SDL_Surface* Renderer::createSurface(int w, int h) {
   return ret;
 }
 
+void Renderer::setTileCacheDir(const string& dir) {
+  tileCacheDir = dir;
+}
+
+SDL_Surface* Renderer::assembleTiles(const string& path, const vector<string>& files, Vec2 size, int setWidth) {
+  int rowLength = setWidth / size.x;
+  SDL_Surface* image = createSurface(setWidth, ((files.size() + rowLength - 1) / rowLength) * size.y);
+  // Decoding dominates the time, so it's done in parallel. Blitting into the sheet stays on this thread.
+  vector<SDL_Surface*> images(files.size());
+  parallelFor(files.size(), [&] (int i) { images[i] = IMG_Load((path + "/" + files[i]).c_str()); });
+  for (int i : All(files)) {
+    SDL_Surface* im = images[i];
+    CHECK(im) << "Failed to load " << files[i];
+    CHECK(im->w == size.x && im->h == size.y) << files[i] << " has wrong size " << im->w << " " << im->h;
+    SDL_Rect offset;
+    offset.x = size.x * (i % rowLength);
+    offset.y = size.y * (i / rowLength);
+    SDL_BlitSurface(im, nullptr, image, &offset);
+    SDL_FreeSurface(im);
+  }
+  return image;
+}
+
+// FNV-1a, so that the hash stored next to the cached sheet doesn't depend on the standard library's std::hash.
+static void fnvHash(uint64_t& hash, const char* data, size_t length) {
+  for (size_t i = 0; i < length; ++i) {
+    hash ^= (unsigned char) data[i];
+    hash *= 1099511628211ULL;
+  }
+}
+
+static void fnvHash(uint64_t& hash, long long value) {
+  char bytes[8];
+  for (int i : Range(8))
+    bytes[i] = char((unsigned long long) value >> (8 * i));
+  fnvHash(hash, bytes, 8);
+}
+
+static void fnvHash(uint64_t& hash, const string& s) {
+  fnvHash(hash, s.c_str(), s.size() + 1);
+}
+
+// The files must be sorted.
+static uint64_t getTilesHash(const string& path, const vector<string>& files, Vec2 size, int setWidth) {
+  uint64_t ret = 14695981039346656037ULL;
+  fnvHash(ret, size.x);
+  fnvHash(ret, size.y);
+  fnvHash(ret, setWidth);
+  for (auto& file : files) {
+    struct stat buf;
+    if (stat((path + "/" + file).c_str(), &buf) == 0) {
+      fnvHash(ret, file);
+      fnvHash(ret, (long long) buf.st_mtime);
+      fnvHash(ret, (long long) buf.st_size);
+    }
+  }
+  return ret;
+}
+
+// Different tile directories with the same tile size get separate cache files.
+static string getTileCacheName(const string& cacheDir, const string& path, Vec2 size, int setWidth) {
+  string dirName = path;
+  for (char& c : dirName)
+    if (!isalnum((unsigned char) c))
+      c = '_';
+  return cacheDir + "/tiles_" + dirName + "_" + toString(size.x) + "_" + toString(setWidth);
+}
+
 bool Renderer::loadTilesFromDir(const string& path, vector<Texture>& tiles, Vec2 size, int setWidth) {
   DIR* dir = opendir(path.c_str());
   if (!dir)
@@ -604,22 +803,30 @@ bool Renderer::loadTilesFromDir(const string& path, vector<Texture>& tiles, Vec2
     if (endsWith(name, imageSuf))
       files.push_back(name);
   }
+  closedir(dir);
+  // The order returned by readdir is arbitrary, and the cached sheet relies on the layout being the same.
+  sort(files.begin(), files.end());
   int rowLength = setWidth / size.x;
-  SDL_Surface* image = createSurface(setWidth, ((files.size() + rowLength - 1) / rowLength) * size.y);
-  CHECK(image) << SDL_GetError();
   for (int i : All(files)) {
-    SDL_Surface* im = IMG_Load((path + "/" + files[i]).c_str());
-    CHECK(im) << files[i] << ": "<< IMG_GetError();
-    CHECK(im->w == size.x && im->h == size.y) << files[i] << " has wrong size " << im->w << " " << im->h;
-    SDL_Rect offset;
-    offset.x = size.x * (i % rowLength);
-    offset.y = size.y * (i / rowLength);
-    SDL_BlitSurface(im, nullptr, image, &offset);
-    CHECK(!tileCoords.count(files[i])) << "Duplicate name " << files[i];
-    tileCoords[files[i].substr(0, files[i].size() - imageSuf.size())] =
-        {{i % rowLength, i / rowLength}, int(tiles.size())};
-    SDL_FreeSurface(im);
+    string name = files[i].substr(0, files[i].size() - imageSuf.size());
+    CHECK(!tileCoords.count(name)) << "Duplicate name " << files[i];
+    tileCoords[name] = {{i % rowLength, i / rowLength}, int(tiles.size())};
   }
+  SDL_Surface* image = nullptr;
+  if (tileCacheDir) {
+    string cacheName = getTileCacheName(*tileCacheDir, path, size, setWidth);
+    string hash = toString(getTilesHash(path, files, size, setWidth));
+    string cachedHash;
+    if (ifstream(cacheName + ".txt") >> cachedHash && cachedHash == hash)
+      image = IMG_Load((cacheName + imageSuf).c_str());
+    if (!image) {
+      Debug() << "Tile cache " << cacheName << " is stale";
+      image = assembleTiles(path, files, size, setWidth);
+      if (IMG_SavePNG(image, (cacheName + imageSuf).c_str()) == 0)
+        ofstream(cacheName + ".txt") << hash;
+    }
+  } else
+    image = assembleTiles(path, files, size, setWidth);
   tiles.push_back(Texture(image));
   SDL_FreeSurface(image);
   return true;
@@ -636,10 +843,12 @@ Vec2 Renderer::getNominalSize() const {
 
 void Renderer::drawAndClearBuffer() {
   for (int i : All(renderList)) {
-    for (auto& elem : renderList[i])
-      elem();
+    renderCommands(renderList[i], textBuffer[i]);
     renderList[i].clear();
+    textBuffer[i].clear();
   }
+  lastFrameStats = frameStats;
+  frameStats = {0, 0, 0, 0};
   setGlScissor(none);
   SDL_GL_SwapWindow(window);  
   glClear(GL_COLOR_BUFFER_BIT);
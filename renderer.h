@@ -93,15 +93,14 @@ class Texture {
   static optional<Texture> loadMaybe(const string& path);
 
   void loadFrom(SDL_Surface*);
+  // Uploads only the given part of the surface. The surface must have the same size as the texture.
+  void loadFrom(SDL_Surface*, Rectangle area);
   const Vec2& getSize() const;
 
   ~Texture();
 
   private:
   friend class Renderer;
-  void render(Vec2 screenP, Vec2 screenK, Vec2 srcP, Vec2 srck, optional<Color> = none,
-      bool vFlip = false, bool hFlip = false) const;
-  void addTexCoord(int x, int y) const;
   optional<GLuint> texId;
   Vec2 size;
   string path;
@@ -164,11 +163,31 @@ class Renderer {
   void drawQuads();
   static Color getBleedingColor(const ViewObject&);
   Vec2 getSize();
+  /** Tile sheets assembled from loose images are saved in this directory, and reused on later launches while
+      none of the images has changed.*/
+  void setTileCacheDir(const string&);
   bool loadTilesFromDir(const string& path, Vec2 size);
   bool loadTilesFromDir(const string& path, vector<Texture>&, Vec2 size, int setWidth);
   bool loadAltTilesFromDir(const string& path, Vec2 altSize);
 
   void drawAndClearBuffer();
+
+  struct FrameStats {
+    int numCommands;
+    int numBatches;
+    int numStateChanges;
+    int numBytes;
+  };
+  /** Returns statistics of the last frame drawn by drawAndClearBuffer. Only the render thread updates them.*/
+  const FrameStats& getFrameStats() const;
+
+  struct TextCacheStats {
+    int hits;
+    int misses;
+  };
+  /** Returns the number of text size cache hits and misses since the renderer was created.*/
+  TextCacheStats getTextCacheStats() const;
+
   void resize(int width, int height);
   bool pollEvent(Event&, EventType);
   bool pollEvent(Event&);
@@ -199,6 +218,8 @@ class Renderer {
   vector<Vec2> tileSize;
   Vec2 nominalSize;
   map<string, TileCoord> tileCoords;
+  optional<string> tileCacheDir;
+  SDL_Surface* assembleTiles(const string& path, const vector<string>& files, Vec2 size, int setWidth);
   bool pollEventWorkaroundMouseReleaseBug(Event&);
   bool pollEventOrFromQueue(Event&);
   void considerMouseMoveEvent(Event&);
@@ -211,11 +232,46 @@ class Renderer {
   bool monkey = false;
   deque<Event> eventQueue;
   bool genReleaseEvent = false;
-  void addRenderElem(function<void()>);
+  struct RenderCommand {
+    enum Type { TEXTURED_QUAD, QUAD, OUTLINE, TEXT } type;
+    GLuint texture;
+    float pos[4];
+    float texCoord[4];
+    Color color;
+    bool hasScissor;
+    int scissor[4];
+    FontId font;
+    int size;
+    CenterType center;
+    int textOffset;
+    optional<Rectangle> getScissor() const;
+    bool canBatchWith(const RenderCommand&) const;
+  };
+  RenderCommand& addRenderCommand(RenderCommand::Type, Vec2 a, Vec2 b, Color);
+  void addTexturedQuad(const Texture&, Vec2 a, Vec2 b, Vec2 p, Vec2 k, optional<Color>, bool vFlip, bool hFlip);
+  void renderCommands(const vector<RenderCommand>&, const vector<char>& text);
+  void renderBatch(const RenderCommand*, const RenderCommand* end);
+  void renderText(const RenderCommand&, const char* text);
   //sf::Text& getTextObject();
   stack<int> layerStack;
   int currentLayer = 0;
-  array<vector<function<void()>>, 2> renderList;
+  array<vector<RenderCommand>, 2> renderList;
+  array<vector<char>, 2> textBuffer;
+  vector<GLfloat> vertexArray;
+  vector<GLfloat> texCoordArray;
+  vector<GLubyte> colorArray;
+  FrameStats frameStats = {0, 0, 0, 0};
+  FrameStats lastFrameStats = {0, 0, 0, 0};
+  // Text is measured from both the game and the render thread.
+  std::mutex textSizeMutex;
+  // One cache per font and size, evicting the least recently used text.
+  struct TextSizeCache {
+    list<pair<string, Vec2>> entries;
+    unordered_map<string, list<pair<string, Vec2>>::iterator> index;
+  };
+  map<pair<int, int>, TextSizeCache> textSizeCache;
+  std::atomic<int> textCacheHits{0};
+  std::atomic<int> textCacheMisses{0};
 //  vector<Vertex> quads;
   Vec2 mousePos;
   struct FontSet {
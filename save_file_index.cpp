@@ -0,0 +1,102 @@
+#include "stdafx.h"
+#include "save_file_index.h"
+#include "parse_game.h"
+#include <sys/types.h>
+#include <sys/stat.h>
+
+typedef StreamCombiner<ofstream, OutputArchive> IndexOutput;
+typedef StreamCombiner<ifstream, InputArchive> IndexInput;
+
+static const int indexVersion = 1;
+
+SaveFileIndex::SaveFileIndex(const string& dir) : directory(dir) {
+}
+
+static string getIndexPath(const string& directory) {
+  return directory + "/saves.idx";
+}
+
+void SaveFileIndex::load() {
+  if (loaded)
+    return;
+  loaded = true;
+  try {
+    IndexInput input(getIndexPath(directory).c_str(), std::ios::binary);
+    int version;
+    input.getArchive() >> BOOST_SERIALIZATION_NVP(version);
+    if (version == indexVersion)
+      input.getArchive() >> BOOST_SERIALIZATION_NVP(entries);
+  } catch (boost::archive::archive_exception& ex) {
+    entries.clear();
+  }
+}
+
+void SaveFileIndex::save() {
+  dirty = false;
+  try {
+    IndexOutput output(getIndexPath(directory).c_str(), std::ios::binary);
+    output.getArchive() << BOOST_SERIALIZATION_NVP(indexVersion) << BOOST_SERIALIZATION_NVP(entries);
+  } catch (boost::archive::archive_exception& ex) {
+    Debug() << "Failed to write save index " << ex.what();
+  }
+}
+
+static optional<pair<time_t, long>> getDateAndSize(const string& path) {
+  struct stat buf;
+  if (stat(path.c_str(), &buf) != 0)
+    return none;
+  return make_pair(buf.st_mtime, long(buf.st_size));
+}
+
+optional<SaveFileIndex::Entry> SaveFileIndex::getEntry(const string& filename) {
+  load();
+  string path = directory + "/" + filename;
+  auto dateAndSize = getDateAndSize(path);
+  if (!dateAndSize) {
+    if (entries.erase(filename))
+      dirty = true;
+    return none;
+  }
+  auto it = entries.find(filename);
+  if (it != entries.end() && it->second.date == dateAndSize->first && it->second.size == dateAndSize->second)
+    return it->second;
+  auto nameAndVersion = ::getNameAndVersion(path);
+  if (!nameAndVersion) {
+    if (entries.erase(filename))
+      dirty = true;
+    return none;
+  }
+  Entry entry {nameAndVersion->first, nameAndVersion->second, ::getSavedGameInfo(path),
+      dateAndSize->first, dateAndSize->second};
+  entries[filename] = entry;
+  dirty = true;
+  return entry;
+}
+
+void SaveFileIndex::flush() {
+  if (dirty)
+    save();
+}
+
+optional<pair<string, int>> SaveFileIndex::getNameAndVersion(const string& filename) {
+  if (auto entry = getEntry(filename))
+    return make_pair(entry->name, entry->gameVersion);
+  else
+    return none;
+}
+
+optional<SavedGameInfo> SaveFileIndex::getSavedGameInfo(const string& filename) {
+  if (auto entry = getEntry(filename))
+    return entry->savedInfo;
+  else
+    return none;
+}
+
+void SaveFileIndex::onSaved(const string& filename, const string& name, int version, const SavedGameInfo& info) {
+  load();
+  if (auto dateAndSize = getDateAndSize(directory + "/" + filename)) {
+    entries[filename] = {name, version, info, dateAndSize->first, dateAndSize->second};
+    save();
+  } else if (entries.erase(filename))
+    save();
+}
@@ -0,0 +1,39 @@
+#ifndef _SAVE_FILE_INDEX_H
+#define _SAVE_FILE_INDEX_H
+
+#include "util.h"
+#include "saved_game_info.h"
+
+/** Caches the header of every save file in a directory, so that listing saves doesn't need to
+    decompress them. Entries are validated against the file's modification time and size.*/
+class SaveFileIndex {
+  public:
+  SaveFileIndex(const string& directory);
+
+  struct Entry {
+    string SERIAL(name);
+    int SERIAL(gameVersion);
+    optional<SavedGameInfo> SERIAL(savedInfo);
+    time_t SERIAL(date);
+    long SERIAL(size);
+    SERIALIZE_ALL(name, gameVersion, savedInfo, date, size);
+  };
+
+  optional<pair<string, int>> getNameAndVersion(const string& filename);
+  optional<SavedGameInfo> getSavedGameInfo(const string& filename);
+  void onSaved(const string& filename, const string& name, int version, const SavedGameInfo&);
+
+  /** Writes the index if any entries were added or removed since it was last written.*/
+  void flush();
+
+  private:
+  optional<Entry> getEntry(const string& filename);
+  void load();
+  void save();
+  string directory;
+  map<string, Entry> entries;
+  bool loaded = false;
+  bool dirty = false;
+};
+
+#endif
@@ -75,6 +75,13 @@ ShortestPath::ShortestPath(Rectangle a, function<double(Vec2)> entryFun, functio
   }
 }
 
+ShortestPath::ShortestPath(Rectangle a, const Table<double>& entryCost, vector<Vec2> dir, Vec2 to, Vec2 from)
+    : target(to), directions(dir), bounds(a) {
+  CHECK(Level::getMaxBounds().contains(a));
+  CHECK(entryCost.getBounds().contains(a));
+  init([&entryCost](Vec2 v) { return entryCost[v]; }, [](Vec2 v) { return v.length4(); }, target, from);
+}
+
 struct QueueElem {
   Vec2 pos;
   double value;
@@ -84,15 +91,14 @@ bool inline operator < (const QueueElem& e1, const QueueElem& e2) {
   return e1.value > e2.value || (e1.value == e2.value && e1.pos < e2.pos);
 }
 
-void ShortestPath::init(function<double(Vec2)> entryFun, function<double(Vec2)> lengthFun, Vec2 target,
-    optional<Vec2> from, optional<int> limit) {
+template <typename EntryFun, typename LengthFun>
+void ShortestPath::init(EntryFun entryFun, LengthFun lengthFun, Vec2 target, optional<Vec2> from,
+    optional<int> limit) {
   reversed = false;
   distanceTable.clear();
-  function<QueueElem(Vec2)> makeElem;
-  if (from)
-    makeElem = [&](Vec2 pos) ->QueueElem { return {pos, distanceTable.getDistance(pos) + lengthFun(*from - pos)}; };
-  else
-    makeElem = [&](Vec2 pos) ->QueueElem { return {pos, distanceTable.getDistance(pos)}; };
+  auto makeElem = [&](Vec2 pos) ->QueueElem {
+    return {pos, distanceTable.getDistance(pos) + (from ? double(lengthFun(*from - pos)) : 0)};
+  };
   priority_queue<QueueElem, vector<QueueElem>> q;
   distanceTable.setDistance(target, 0);
   q.push(makeElem(target));
@@ -212,17 +218,20 @@ ShortestPath LevelShortestPath::makeShortestPath(const Creature* creature, Posit
   Level* level = from.getLevel();
   Rectangle bounds = level->getBounds();
   CHECK(to.isSameLevel(from));
-  auto entryFun = [=](Vec2 v) { 
+  const Sectors& navigable = level->getSectors(creature->getMovementType());
+  auto entryFun = [=, &navigable](Vec2 v) { 
       Position pos(v, level);
-      if (pos.canEnter(creature) || creature->getPosition() == pos) 
+      if (creature->getPosition() == pos)
         return 1.0;
-      if (pos.canNavigate(creature->getMovementType())) {
-        if (const Creature* other = pos.getCreature())
-          if (other->isFriend(creature) && other->hasFreeMovement())
-            return 2.1;
-        return 5.0;
-      }
-      return ShortestPath::infinity;};
+      // Most of the rejected squares are walls, so test the compact navigability layer before the square itself.
+      if (!navigable.contains(v))
+        return ShortestPath::infinity;
+      if (pos.canEnter(creature))
+        return 1.0;
+      if (const Creature* other = pos.getCreature())
+        if (other->isFriend(creature) && other->hasFreeMovement())
+          return 2.1;
+      return 5.0;};
   CHECK(to.getCoord().inRectangle(level->getBounds()));
   CHECK(from.getCoord().inRectangle(level->getBounds()));
   if (mult == 0)
@@ -34,6 +34,13 @@ class ShortestPath {
       Vec2 target,
       Vec2 from,
       double mult = 0);
+  /** Uses precomputed entry costs and a Manhattan distance heuristic, which suits 4-directional movement.*/
+  ShortestPath(
+      Rectangle area,
+      const Table<double>& entryCost,
+      vector<Vec2> directions,
+      Vec2 target,
+      Vec2 from);
   bool isReachable(Vec2 pos) const;
   Vec2 getNextMove(Vec2 pos);
   Vec2 getTarget() const;
@@ -44,8 +51,8 @@ class ShortestPath {
   SERIALIZATION_DECL(ShortestPath);
 
   private:
-  void init(function<double(Vec2)> entryFun, function<double(Vec2)> lengthFun, Vec2 target, optional<Vec2> from,
-      optional<int> limit = none);
+  template <typename EntryFun, typename LengthFun>
+  void init(EntryFun entryFun, LengthFun lengthFun, Vec2 target, optional<Vec2> from, optional<int> limit = none);
   void reverse(function<double(Vec2)> entryFun, function<double(Vec2)> lengthFun, double mult, Vec2 from, int limit);
   void constructPath(Vec2 start, bool reversed = false);
   vector<Vec2> SERIAL(path);
@@ -461,7 +461,8 @@ void Square::addTrigger(Position pos, PTrigger t) {
   setDirty(pos);
   pos.getLevel()->addTickingSquare(pos.getCoord());
   Trigger* ref = t.get();
-  pos.getLevel()->addLightSource(pos.getCoord(), t->getLightEmission());
+  if (t->getLightEmission() > 0)
+    pos.getLevel()->updateLightSource(pos.getCoord());
   triggers.push_back(std::move(t));
 }
 
@@ -476,7 +477,8 @@ PTrigger Square::removeTrigger(Position pos, Trigger* trigger) {
     if (t.get() == trigger) {
       PTrigger ret = std::move(t);
       removeElement(triggers, t);
-      pos.getLevel()->removeLightSource(pos.getCoord(), ret->getLightEmission());
+      if (ret->getLightEmission() > 0)
+        pos.getLevel()->updateLightSource(pos.getCoord());
       return ret;
     }
   FAIL << "Trigger not found";
@@ -497,10 +499,7 @@ Creature* Square::getCreature() const {
 void Square::removeCreature(Position pos) {
   setDirty(pos);
   CHECK(creature);
-  Creature* tmp = creature;
   creature = nullptr;
-  if (tmp->getAttributes().isStationary())
-    pos.getLevel()->updateConnectivity(pos.getCoord());
 }
 
 bool Square::canSeeThru(VisionId v) const {
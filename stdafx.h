@@ -35,6 +35,7 @@
 #include <unordered_set>
 #include <unordered_map>
 #include <queue>
+#include <list>
 #include <random>
 #include <stack>
 #include <stdexcept>
@@ -118,6 +119,8 @@ using std::pair;
 using std::tuple;
 using std::out_of_range;
 using std::unordered_map;
+using std::unordered_multimap;
+using std::list;
 using std::bitset;
 using std::min;
 using std::max;
@@ -71,7 +71,15 @@ bool Task::isDone() {
 }
 
 void Task::setDone() {
-  done = true;
+  if (!done) {
+    done = true;
+    if (onDone)
+      onDone(this);
+  }
+}
+
+void Task::setOnDone(function<void(Task*)> f) {
+  onDone = f;
 }
 
 namespace {
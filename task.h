@@ -39,6 +39,8 @@ class Task : public UniqueEntity<Task> {
   virtual string getDescription() const = 0;
   virtual bool canPerform(const Creature* c);
   bool isDone();
+  /** Sets a function called once when the task is done. It isn't serialized.*/
+  void setOnDone(function<void(Task*)>);
 
   static PTask construction(TaskCallback*, Position, const SquareType&);
   static PTask buildTorch(TaskCallback*, Position, Dir attachmentDir);
@@ -87,6 +89,7 @@ class Task : public UniqueEntity<Task> {
   private:
   bool SERIAL(done) = false;
   bool SERIAL(transfer);
+  function<void(Task*)> onDone;
 };
 
 #endif
@@ -2,6 +2,7 @@
 #include "task_map.h"
 #include "creature.h"
 #include "task.h"
+#include "level.h"
 
 template <class Archive>
 void TaskMap::serialize(Archive& ar, const unsigned int version) {
@@ -19,28 +20,109 @@ void TaskMap::serialize(Archive& ar, const unsigned int version) {
 
 SERIALIZABLE(TaskMap);
 
+const static int indexBucketSize = 8;
+
+// The index isn't serialized, it's rebuilt on first use after loading.
+void TaskMap::updateIndex() {
+  if (indexUpToDate)
+    return;
+  indexUpToDate = true;
+  taskIndices.clear();
+  positionIndex.clear();
+  priorityIndex.clear();
+  priorityPositions.clear();
+  doneTasks.clear();
+  for (int i : All(tasks)) {
+    Task* task = tasks[i].get();
+    taskIndices[task] = i;
+    addToIndex(task);
+    if (positionMap.count(task) && isPriorityTask(task))
+      addToPriorityIndex(task);
+    watchDone(task);
+    if (task->isDone())
+      doneTasks.push_back(task);
+  }
+}
+
+void TaskMap::watchDone(Task* task) {
+  task->setOnDone([this] (Task* t) { doneTasks.push_back(t); });
+}
+
+void TaskMap::removeDoneTasks() {
+  vector<Task*> done;
+  swap(done, doneTasks);
+  for (Task* task : done)
+    removeTask(task);
+}
+
+void TaskMap::addToPriorityIndex(Task* task) {
+  priorityPositions[task] = priorityIndex.insert(priorityIndex.end(), task);
+}
+
+void TaskMap::addToIndex(Task* task) {
+  if (positionMap.count(task)) {
+    Position pos = positionMap.at(task);
+    auto key = make_pair(requiredTraits.at(task), pos.getLevel());
+    auto index = positionIndex.find(key);
+    if (index == positionIndex.end()) {
+      Rectangle bounds = pos.getLevel()->getBounds();
+      index = positionIndex.insert(make_pair(key,
+            TaskBucketMap(bounds.right(), bounds.bottom(), indexBucketSize))).first;
+    }
+    index->second.addElement(pos.getCoord(), task);
+  }
+}
+
+void TaskMap::removeFromIndex(Task* task) {
+  if (positionMap.count(task)) {
+    Position pos = positionMap.at(task);
+    positionIndex.at(make_pair(requiredTraits.at(task), pos.getLevel())).removeElement(pos.getCoord(), task);
+  }
+  auto priority = priorityPositions.find(task);
+  if (priority != priorityPositions.end()) {
+    priorityIndex.erase(priority->second);
+    priorityPositions.erase(priority);
+  }
+}
+
+bool TaskMap::isAvailable(Task* task, Creature* c) {
+  Position pos = positionMap.at(task);
+  int dist = pos.dist8(c->getPosition());
+  const Creature* owner = getOwner(task);
+  optional<double> delayed = delayedTasks.getMaybe(task);
+  return !task->isDone() && task->canPerform(c) &&
+      (!owner || (task->canTransfer() && pos.dist8(owner->getPosition()) > dist && dist <= 6)) &&
+      c->canNavigateTo(pos) &&
+      (!delayed || *delayed < c->getLocalTime());
+}
+
 Task* TaskMap::getClosestTask(Creature* c, MinionTrait trait) {
-  if (Random.roll(20))
-    for (Task* t : extractRefs(tasks))
-      if (t->isDone())
-        removeTask(t);
+  updateIndex();
+  removeDoneTasks();
+  for (Task* task : priorityIndex)
+    if (requiredTraits.at(task) == trait && isAvailable(task, c))
+      return task;
+  Position position = c->getPosition();
+  auto index = positionIndex.find(make_pair(trait, position.getLevel()));
+  if (index == positionIndex.end())
+    return nullptr;
+  const TaskBucketMap& buckets = index->second;
   Task* closest = nullptr;
-  for (PTask& task : tasks)
-    if (requiredTraits.count(task.get()) && requiredTraits.at(task.get()) == trait && task->canPerform(c))
-      if (auto pos = getPosition(task.get())) {
-        double dist = pos->dist8(c->getPosition());
-        const Creature* owner = getOwner(task.get());
-        optional<double> delayed = delayedTasks.getMaybe(task.get());
-        if (!task->isDone() &&
-            (!owner || (task->canTransfer() && pos->dist8(owner->getPosition()) > dist && dist <= 6)) &&
-            (!closest || dist < getPosition(closest)->dist8(c->getPosition()) || isPriorityTask(task.get())) &&
-            c->canNavigateTo(*pos) &&
-            (!delayed || *delayed < c->getLocalTime())) {
-          closest = task.get();
-          if (isPriorityTask(task.get()))
-            return task.get();
-        }
+  int closestDist = 0;
+  for (int ring : Range(buckets.getMaxRing(position.getCoord()) + 1)) {
+    if (closest && buckets.getMinDistance(ring) > closestDist)
+      break;
+    for (Task* task : buckets.getElementsInRing(position.getCoord(), ring)) {
+      int dist = positionMap.at(task).dist8(position);
+      // Buckets are unordered, so break ties by id to stay deterministic.
+      if ((!closest || dist < closestDist ||
+            (dist == closestDist && task->getUniqueId() < closest->getUniqueId())) &&
+          isAvailable(task, c)) {
+        closest = task;
+        closestDist = dist;
       }
+    }
+  }
   return closest;
 }
 
@@ -54,8 +136,12 @@ void TaskMap::freeTaskDelay(Task* t, double d) {
 }
 
 void TaskMap::setPriorityTasks(Position pos) {
+  updateIndex();
   for (Task* t : getTasks(pos))
-    priorityTasks.insert(t);
+    if (!isPriorityTask(t)) {
+      priorityTasks.insert(t);
+      addToPriorityIndex(t);
+    }
 }
 
 Task* TaskMap::addTaskCost(PTask task, Position position, CostInfo cost) {
@@ -64,6 +150,7 @@ Task* TaskMap::addTaskCost(PTask task, Position position, CostInfo cost) {
 }
 
 CostInfo TaskMap::removeTask(Task* task) {
+  updateIndex();
   if (!task->isDone())
     task->cancel();
   CostInfo cost;
@@ -73,11 +160,15 @@ CostInfo TaskMap::removeTask(Task* task) {
   }
   if (auto pos = getPosition(task))
     marked.set(*pos, nullptr);
-  for (int i : All(tasks))
-    if (tasks[i].get() == task) {
-      removeIndex(tasks, i);
-      break;
-    }
+  removeFromIndex(task);
+  removeElementMaybe(doneTasks, task);
+  if (taskIndices.count(task)) {
+    int i = taskIndices.at(task);
+    taskIndices.erase(task);
+    removeIndex(tasks, i);
+    if (i < tasks.size())
+      taskIndices[tasks[i].get()] = i;
+  }
   if (creatureMap.contains(task))
     creatureMap.erase(task);
   if (positionMap.count(task)) {
@@ -151,7 +242,10 @@ const vector<Task*>& TaskMap::getTasks(Position pos) const {
 }
 
 Task* TaskMap::addTask(PTask task, const Creature* c) {
+  updateIndex();
   creatureMap.insert(c, task.get());
+  watchDone(task.get());
+  taskIndices[task.get()] = tasks.size();
   tasks.push_back(std::move(task));
   return tasks.back().get();
 }
@@ -163,9 +257,13 @@ Task* TaskMap::addPriorityTask(PTask task, const Creature* c) {
 }
 
 Task* TaskMap::addTask(PTask task, Position position, MinionTrait required) {
+  updateIndex();
   positionMap[task.get()] = position;
   requiredTraits[task.get()] = required;
   reversePositions.getOrInit(position).push_back(task.get());
+  addToIndex(task.get());
+  watchDone(task.get());
+  taskIndices[task.get()] = tasks.size();
   tasks.push_back(std::move(task));
   return tasks.back().get();
 }
@@ -7,6 +7,7 @@
 #include "cost_info.h"
 #include "position_map.h"
 #include "minion_task.h"
+#include "bucket_map.h"
 
 class Task;
 class Creature;
@@ -44,6 +45,13 @@ class TaskMap {
   void serialize(Archive& ar, const unsigned int version);
 
   private:
+  void updateIndex();
+  void addToIndex(Task*);
+  void removeFromIndex(Task*);
+  void addToPriorityIndex(Task*);
+  void watchDone(Task*);
+  void removeDoneTasks();
+  bool isAvailable(Task*, Creature*);
   BiMap<const Creature*, Task*> SERIAL(creatureMap);
   unordered_map<Task*, Position> SERIAL(positionMap);
   PositionMap<vector<Task*>> SERIAL(reversePositions);
@@ -54,6 +62,14 @@ class TaskMap {
   EntityMap<Task, double> SERIAL(delayedTasks);
   EntitySet<Task> SERIAL(priorityTasks);
   unordered_map<Task*, MinionTrait> SERIAL(requiredTraits);
+  bool indexUpToDate = false;
+  unordered_map<Task*, int> taskIndices;
+  map<pair<MinionTrait, Level*>, TaskBucketMap> positionIndex;
+  list<Task*> priorityIndex;
+  unordered_map<Task*, list<Task*>::iterator> priorityPositions;
+  // Tasks that were done since the last call to getClosestTask. They are removed there and not when they
+  // complete, because the task's own code is still running at that point.
+  vector<Task*> doneTasks;
 };
 
 #endif
@@ -13,6 +13,7 @@ SERIALIZABLE(Territory);
 void Territory::clearCache() {
   extendedCache.clear();
   extendedCache2.clear();
+  extendedAreaCache.clear();
 }
 
 void Territory::insert(Position pos) {
@@ -77,6 +78,26 @@ const vector<Position>& Territory::getExtended(int max) const {
   return extendedCache2.at(max);
 }
 
+const Territory::ExtendedArea& Territory::getExtendedArea(int max) const {
+  if (!extendedAreaCache.count(max)) {
+    ExtendedArea& area = extendedAreaCache[max];
+    const vector<Position>& extended = getExtended(max);
+    area.squares = set<Position>(extended.begin(), extended.end());
+    if (!extended.empty())
+      area.bounds = Rectangle::boundingBox(transform2<Vec2>(extended,
+            [] (const Position& p) { return p.getCoord(); }));
+  }
+  return extendedAreaCache.at(max);
+}
+
+bool Territory::isInExtended(Position pos, int max) const {
+  return getExtendedArea(max).squares.count(pos);
+}
+
+optional<Rectangle> Territory::getExtendedBounds(int max) const {
+  return getExtendedArea(max).bounds;
+}
+
 bool Territory::isEmpty() const {
   return allSquaresVec.empty();
 }
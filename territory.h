@@ -13,6 +13,9 @@ class Territory {
   const vector<Position>& getExtended(int min, int max) const;
   const vector<Position>& getExtended(int max) const;
   const vector<Position>& getStandardExtended() const;
+  /** Membership test and bounding box for getExtended(max), so callers can query a spatial index instead.*/
+  bool isInExtended(Position, int max) const;
+  optional<Rectangle> getExtendedBounds(int max) const;
   bool isEmpty() const;
 
   template <class Archive>
@@ -25,6 +28,12 @@ class Territory {
   vector<Position> SERIAL(allSquaresVec);
   mutable map<pair<int, int>, vector<Position>> extendedCache;
   mutable map<int, vector<Position>> extendedCache2;
+  struct ExtendedArea {
+    set<Position> squares;
+    optional<Rectangle> bounds;
+  };
+  const ExtendedArea& getExtendedArea(int max) const;
+  mutable map<int, ExtendedArea> extendedAreaCache;
 };
 
 #endif
@@ -21,6 +21,20 @@
 #include "level_maker.h"
 #include "test.h"
 #include "sectors.h"
+#include "entity_map.h"
+#include "entity_set.h"
+#include "map_memory.h"
+#include "position_map.h"
+#include "view_index.h"
+#include "view_object.h"
+#include "level.h"
+#include "level_builder.h"
+#include "square.h"
+#include "creature.h"
+#include "model.h"
+#include "save_file_index.h"
+#include "parse_game.h"
+#include <boost/filesystem.hpp>
 
 void testStringConvertion() {
   CHECK(toString(1234) == "1234");
@@ -433,6 +447,182 @@ void testReverse3() {
   CHECKEQ(reverse2(v1), v2);
 }
 
+void testEntityMap() {
+  vector<UniqueEntity<Creature>::Id> ids(100);
+  EntityMap<Creature, int> m;
+  EntitySet<Creature> s;
+  for (int i : All(ids)) {
+    m.set(ids[i], i);
+    s.insert(ids[i]);
+    s.insert(ids[i]);
+  }
+  CHECKEQ(m.getSize(), 100);
+  CHECKEQ(s.getSize(), 100);
+  for (int i : All(ids)) {
+    CHECKEQ(m.getOrFail(ids[i]), i);
+    CHECK(s.contains(ids[i]));
+  }
+  for (int i : All(ids))
+    if (i % 2 == 0) {
+      m.erase(ids[i]);
+      s.erase(ids[i]);
+    }
+  CHECKEQ(m.getSize(), 50);
+  CHECKEQ(s.getSize(), 50);
+  for (int i : All(ids)) {
+    CHECKEQ(!!m.getMaybe(ids[i]), i % 2 == 1);
+    CHECKEQ(s.contains(ids[i]), i % 2 == 1);
+  }
+  sort(ids.begin(), ids.end());
+  ids = filter(ids, [&](UniqueEntity<Creature>::Id id) { return s.contains(id); });
+  CHECK(vector<UniqueEntity<Creature>::Id>(s.begin(), s.end()) == ids);
+}
+
+void testParallelFor() {
+  for (int size : {0, 5, 1000}) {
+    vector<int> v(size, -1);
+    parallelFor(size, [&] (int i) { v[i] = i * i; });
+    for (int i : All(v))
+      CHECKEQ(v[i], i * i);
+  }
+}
+
+void testTableSerialization() {
+  vector<double> v(1000, 0.5);
+  for (int i : Range(300, 700))
+    v[i] = i / 100;
+  v.back() = -1;
+  string data = TableSerialization::encode((const char*) v.data(), v.size(), sizeof(double));
+  CHECK(data.size() < 1000);
+  vector<double> decoded(v.size());
+  TableSerialization::decode(data, (char*) decoded.data(), v.size(), sizeof(double));
+  CHECK(decoded == v);
+}
+
+void testRandomStreams() {
+  RandomGen gen;
+  gen.init(123);
+  RandomGen s1 = gen.getStream("worldgen");
+  for (int i : Range(100))
+    CHECK(gen.get(5, 10) >= 5);
+  RandomGen s2 = gen.getStream("worldgen");
+  RandomGen s3 = gen.getStream("combat");
+  bool different = false;
+  for (int i : Range(100)) {
+    int v = s1.get(1000);
+    CHECKEQ(v, s2.get(1000));
+    if (v != s3.get(1000))
+      different = true;
+  }
+  CHECK(different);
+}
+
+// Same stream layout as MapMemory had before it got a class version.
+struct LegacyMapMemory {
+  HeapAllocated<PositionMap<optional<ViewIndex>>> SERIAL(table);
+
+  template <class Archive>
+  void serialize(Archive& ar, const unsigned int version) {
+    ar & SVAR(table);
+  }
+};
+
+void testMapMemoryLegacyLoad() {
+  Model model;
+  PLevel level1 = LevelBuilder(Random, 10, 10, "level1", false)
+      .build(&model, LevelMaker::emptyLevel(Random).get(), 1);
+  PLevel level2 = LevelBuilder(Random, 10, 10, "level2", false)
+      .build(&model, LevelMaker::emptyLevel(Random).get(), 2);
+  ViewIndex floor;
+  floor.insert(ViewObject(ViewId::FLOOR, ViewLayer::FLOOR, "Floor"));
+  ViewIndex wall;
+  wall.insert(ViewObject(ViewId::WALL, ViewLayer::FLOOR, "Wall"));
+  vector<pair<Position, ViewIndex>> remembered {
+      {Position(Vec2(2, 3), level1.get()), floor},
+      {Position(Vec2(5, 3), level1.get()), floor},
+      {Position(Vec2(7, 8), level1.get()), wall},
+      {Position(Vec2(1, 1), level2.get()), floor},
+      {Position(Vec2(9, 0), level2.get()), wall}};
+  stringstream stream;
+  {
+    OutputArchive output(stream);
+    LegacyMapMemory memory;
+    for (auto& elem : remembered)
+      memory.table->set(elem.first, elem.second);
+    int sentinel = 1234;
+    output << SVAR(memory) << SVAR(sentinel);
+  }
+  InputArchive input(stream);
+  MapMemory memory;
+  int sentinel = 0;
+  input >> SVAR(memory) >> SVAR(sentinel);
+  CHECKEQ(sentinel, 1234);
+  for (auto& elem : remembered)
+    CHECK(memory.getViewIndex(elem.first) == elem.second);
+  CHECK(!memory.getViewIndex(Position(Vec2(3, 3), level1.get())));
+  CHECK(!memory.getViewIndex(Position(Vec2(0, 9), level2.get())));
+  CHECKEQ(memory.getNumSharing(remembered[0].first), 3);
+  CHECKEQ(memory.getNumSharing(remembered[2].first), 2);
+  CHECK(memory.getUpdated(level1.get()).empty());
+  CHECK(memory.getUpdated(level2.get()).empty());
+  // Outside of the loaded bounds, which only cover the remembered part of the level.
+  Position outside(Vec2(0, 9), level1.get());
+  memory.clearSquare(remembered[0].first);
+  memory.update(outside, wall);
+  CHECKEQ(memory.getUpdated(level1.get()).size(), 2);
+  CHECK(memory.getUpdated(level2.get()).empty());
+  CHECK(!memory.getViewIndex(remembered[0].first));
+  CHECK(memory.getViewIndex(outside)->hasObject(ViewLayer::FLOOR));
+  CHECKEQ(memory.getNumSharing(remembered[1].first), 2);
+  CHECKEQ(memory.getNumSharing(outside), 1);
+  CHECKEQ(memory.getNumSharing(remembered[2].first), 2);
+  for (int i : Range(1, remembered.size()))
+    CHECK(memory.getViewIndex(remembered[i].first) == remembered[i].second);
+}
+
+static void writeTestSave(const string& path, const string& name) {
+  CompressedOutput out(path.c_str());
+  int version = 900;
+  SavedGameInfo savedInfo({}, 1.5, name, 1);
+  out.getArchive() << BOOST_SERIALIZATION_NVP(version) << BOOST_SERIALIZATION_NVP(name)
+      << BOOST_SERIALIZATION_NVP(savedInfo);
+}
+
+void testSaveFileIndex() {
+  namespace fs = boost::filesystem;
+  fs::path dir = fs::temp_directory_path() / fs::unique_path();
+  fs::create_directories(dir);
+  string path = (dir / "test.sav").string();
+  writeTestSave(path, "first");
+  {
+    SaveFileIndex index(dir.string());
+    CHECK(index.getNameAndVersion("test.sav") == make_pair(string("first"), 900));
+    CHECK(!index.getNameAndVersion("missing.sav"));
+    index.flush();
+  }
+  // Same size and date, so the entry is read from the index instead of the unreadable file.
+  auto date = fs::last_write_time(path);
+  auto size = fs::file_size(path);
+  {
+    ofstream(path.c_str(), std::ios::binary) << string(size, 'x');
+  }
+  fs::last_write_time(path, date);
+  {
+    SaveFileIndex index(dir.string());
+    CHECK(index.getNameAndVersion("test.sav") == make_pair(string("first"), 900));
+    CHECK(index.getSavedGameInfo("test.sav")->getName() == "first");
+  }
+  // A different save replaces the stale entry.
+  writeTestSave(path, "second game with a longer name");
+  {
+    SaveFileIndex index(dir.string());
+    CHECK(index.getNameAndVersion("test.sav") == make_pair(string("second game with a longer name"), 900));
+    fs::remove(path);
+    CHECK(!index.getNameAndVersion("test.sav"));
+  }
+  fs::remove_all(dir);
+}
+
 int testAll() {
   testStringConvertion();
   testTimeQueue();
@@ -463,6 +653,12 @@ int testAll() {
   testReverse();
   testReverse2();
   testReverse3();
+  testEntityMap();
+  testParallelFor();
+  testTableSerialization();
+  testRandomStreams();
+  testMapMemoryLegacyLoad();
+  testSaveFileIndex();
   Debug() << "-----===== OK =====-----";
   return 0;
 }
@@ -30,13 +30,39 @@ SERIALIZATION_CONSTRUCTOR_IMPL(Tribe);
 Tribe::Tribe(bool d) : diplomatic(d) {
 }
 
+int Tribe::getNewIndex() {
+  static int numTribes = 0;
+  return numTribes++;
+}
+
+static int relationsVersion = 0;
+
+int Tribe::getRelationsVersion() {
+  return relationsVersion;
+}
+
+void Tribe::onRelationsChanged() {
+  ++relationsVersion;
+}
+
+void Tribe::updateHostility() const {
+  hostility.clear();
+  for (const Tribe* t : enemyTribes) {
+    if (t->index >= hostility.size())
+      hostility.resize(t->index + 1, false);
+    hostility[t->index] = true;
+  }
+  hostilityValid = true;
+}
+
 double Tribe::getStanding(const Creature* c) const {
-  if (enemyTribes.count(const_cast<Tribe*>(c->getTribe())))
+  if (isEnemy(c->getTribe()))
     return -1;
   if (c->getTribe() == this)
     return 1;
-  if (auto res = standing.getMaybe(c)) 
-    return *res;
+  if (!standing.empty())
+    if (auto res = standing.getMaybe(c)) 
+      return *res;
   return 0;
 }
 
@@ -48,12 +74,16 @@ void Tribe::addEnemy(Tribe* t) {
   enemyTribes.insert(t);
   if (t != this)
     t->enemyTribes.insert(this);
+  hostilityValid = t->hostilityValid = false;
+  onRelationsChanged();
 }
 
 void Tribe::addFriend(Tribe* t) {
   CHECK(t != this);
   enemyTribes.erase(t);
   t->enemyTribes.erase(this);
+  hostilityValid = t->hostilityValid = false;
+  onRelationsChanged();
 }
 
 static const double killBonus = 0.1;
@@ -69,6 +99,7 @@ void Tribe::onMemberKilled(Creature* member, Creature* attacker) {
   CHECK(member->getTribe() == this);
   if (attacker == nullptr)
     return;
+  onRelationsChanged();
   initStanding(attacker);
   standing.getOrFail(attacker) -= killPenalty * getMultiplier(member);
   for (Tribe* t : enemyTribes)
@@ -83,11 +114,14 @@ bool Tribe::isEnemy(const Creature* c) const {
 }
 
 bool Tribe::isEnemy(const Tribe* t) const {
-  return enemyTribes.count(const_cast<Tribe*>(t));
+  if (!hostilityValid)
+    updateHostility();
+  return t->index < hostility.size() && hostility[t->index];
 }
 
 void Tribe::onItemsStolen(const Creature* attacker) {
   if (diplomatic) {
+    onRelationsChanged();
     initStanding(attacker);
     standing.getOrFail(attacker) -= thiefPenalty;
   }
@@ -78,6 +78,11 @@ class Tribe {
   void onMemberKilled(Creature* member, Creature* killer);
   void onItemsStolen(const Creature* thief);
 
+  /** Changes whenever any standing or hostility between tribes or creatures changes, so that cached results of
+      Creature::isEnemy can be validated.*/
+  static int getRelationsVersion();
+  static void onRelationsChanged();
+
   SERIALIZATION_DECL(Tribe);
 
   typedef unordered_map<TribeId, PTribe, CustomHash<TribeId>> Map;
@@ -95,6 +100,13 @@ class Tribe {
 
   EntityMap<Creature, double> SERIAL(standing);
   unordered_set<Tribe*> SERIAL(enemyTribes);
+  // Every Tribe gets a process-wide index, which is used to keep each tribe's row of the hostility matrix
+  // as a dense bit vector. The row is rebuilt from enemyTribes after it changes.
+  static int getNewIndex();
+  void updateHostility() const;
+  int index = getNewIndex();
+  mutable vector<bool> hostility;
+  mutable bool hostilityValid = false;
 };
 
 #endif
@@ -18,8 +18,66 @@
 #include "util.h"
 #include "position.h"
 
-void RandomGen::init(int seed) {
-  generator.seed(seed);
+static uint64_t splitMix(uint64_t& x) {
+  uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+static uint64_t rotateLeft(uint64_t x, int k) {
+  return (x << k) | (x >> (64 - k));
+}
+
+void RandomGen::initState(uint64_t s) {
+  seed = s;
+  for (auto& elem : state)
+    elem = splitMix(s);
+}
+
+RandomGen::RandomGen() {
+  initState(0);
+}
+
+void RandomGen::init(int s) {
+  initState(s);
+}
+
+RandomGen RandomGen::getStream(long long streamId) const {
+  uint64_t x = seed ^ rotateLeft(streamId, 32);
+  RandomGen ret;
+  ret.initState(splitMix(x) ^ streamId);
+  return ret;
+}
+
+RandomGen RandomGen::getStream(const string& streamName) const {
+  // FNV-1a, because std::hash is not guaranteed to be the same across platforms.
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (unsigned char c : streamName)
+    hash = (hash ^ c) * 0x100000001b3ULL;
+  return getStream((long long) hash);
+}
+
+uint64_t RandomGen::next() {
+  uint64_t ret = rotateLeft(state[1] * 5, 7) * 9;
+  uint64_t t = state[1] << 17;
+  state[2] ^= state[0];
+  state[3] ^= state[1];
+  state[1] ^= state[2];
+  state[0] ^= state[3];
+  state[2] ^= t;
+  state[3] = rotateLeft(state[3], 45);
+  return ret;
+}
+
+uint64_t RandomGen::getBounded(uint64_t range) {
+  // Rejects the lowest values, so that the remainder is uniformly distributed.
+  uint64_t threshold = (0 - range) % range;
+  while (1) {
+    uint64_t r = next();
+    if (r >= threshold)
+      return r % range;
+  }
 }
 
 int RandomGen::get(int max) {
@@ -27,7 +85,13 @@ int RandomGen::get(int max) {
 }
 
 long long RandomGen::getLL() {
-  return uniform_int_distribution<long long>(-(1LL << 62), 1LL << 62)(generator);
+  // Returns a value in [-2^62, 2^62]. The offset is applied in unsigned arithmetic to avoid overflow.
+  const uint64_t offset = 1ULL << 62;
+  uint64_t r = getBounded((1ULL << 63) + 1);
+  if (r >= offset)
+    return (long long) (r - offset);
+  else
+    return -(long long) (offset - r);
 }
 
 int RandomGen::get(Range r) {
@@ -36,7 +100,7 @@ int RandomGen::get(Range r) {
 
 int RandomGen::get(int min, int max) {
   CHECK(max > min);
-  return uniform_int_distribution<int>(min, max - 1)(generator);
+  return min + (int) getBounded((long long) max - min);
 }
 
 std::string operator "" _s(const char* str, size_t) { 
@@ -80,11 +144,11 @@ bool RandomGen::rollD(double chance) {
 }
 
 double RandomGen::getDouble() {
-  return defaultDist(generator);
+  return (next() >> 11) * (1.0 / (1ULL << 53));
 }
 
 double RandomGen::getDouble(double a, double b) {
-  return uniform_real_distribution<double>(a, b)(generator);
+  return a + (b - a) * getDouble();
 }
 
 RandomGen Random;
@@ -817,6 +881,78 @@ AsyncLoop::~AsyncLoop() {
   t.join();
 }
 
+static bool isBigEndian() {
+  const uint16_t one = 1;
+  return *(const char*) &one == 0;
+}
+
+// Each run is stored as its length in 7-bit groups, followed by the element bytes in little-endian order.
+string TableSerialization::encode(const char* elems, int numElems, int elemSize) {
+  string ret;
+  bool swap = isBigEndian();
+  for (int i = 0; i < numElems;) {
+    const char* elem = elems + i * elemSize;
+    int run = 1;
+    while (i + run < numElems && !memcmp(elem, elem + run * elemSize, elemSize))
+      ++run;
+    for (int len = run; ; len >>= 7) {
+      ret.push_back(char(len & 127) | (len >= 128 ? char(128) : 0));
+      if (len < 128)
+        break;
+    }
+    for (int j : Range(elemSize))
+      ret.push_back(elem[swap ? elemSize - 1 - j : j]);
+    i += run;
+  }
+  return ret;
+}
+
+void TableSerialization::decode(const string& data, char* elems, int numElems, int elemSize) {
+  bool swap = isBigEndian();
+  int pos = 0;
+  for (int i = 0; i < numElems;) {
+    int run = 0;
+    for (int shift = 0; ; shift += 7) {
+      CHECK(pos < data.size()) << "Table data too short";
+      unsigned char byte = data[pos++];
+      run |= int(byte & 127) << shift;
+      if (byte < 128)
+        break;
+    }
+    CHECK(run > 0 && i + run <= numElems && pos + elemSize <= data.size()) << "Corrupted table data";
+    char* elem = elems + i * elemSize;
+    for (int j : Range(elemSize))
+      elem[swap ? elemSize - 1 - j : j] = data[pos + j];
+    pos += elemSize;
+    for (int j : Range(1, run))
+      memcpy(elem + j * elemSize, elem, elemSize);
+    i += run;
+  }
+  CHECK(pos == data.size()) << "Corrupted table data";
+}
+
+void parallelFor(int size, function<void(int)> fun) {
+  const int chunkSize = 16;
+  int numThreads = min<int>(thread::hardware_concurrency(), size / chunkSize);
+  if (numThreads < 2) {
+    for (int i : Range(size))
+      fun(i);
+    return;
+  }
+  std::atomic<int> next(0);
+  auto work = [&] {
+    for (int begin = next.fetch_add(chunkSize); begin < size; begin = next.fetch_add(chunkSize))
+      for (int i : Range(begin, min(size, begin + chunkSize)))
+        fun(i);
+  };
+  vector<thread> threads;
+  for (int i : Range(numThreads - 1))
+    threads.emplace_back(work);
+  work();
+  for (auto& t : threads)
+    t.join();
+}
+
 ConstructorFunction::ConstructorFunction(function<void()> fun) {
   fun();
 }
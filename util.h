@@ -335,9 +335,17 @@ class EnumInfo<Name> { \
 std::string operator "" _s(const char* str, size_t);
 class RandomGen {
   public:
-  RandomGen() {}
-  RandomGen(RandomGen&) = delete;
+  RandomGen();
+  RandomGen(const RandomGen&) = default;
+  RandomGen(RandomGen&&) = default;
+  RandomGen& operator = (const RandomGen&) = default;
+  RandomGen& operator = (RandomGen&&) = default;
   void init(int seed);
+  /** Returns a generator for an independent stream of numbers. It depends only on the seed of this generator and
+      the stream id, and not on how many numbers were drawn from either, so code that runs in a different order,
+      or in parallel, stays reproducible from one seed.*/
+  RandomGen getStream(long long streamId) const;
+  RandomGen getStream(const string& streamName) const;
   int get(int max);
   long long getLL();
   int get(int min, int max);
@@ -355,15 +363,14 @@ class RandomGen {
 
   template <typename T>
   T choose(const vector<T>& v) {
-    vector<double> pi(v.size(), 1);
-    return choose(v, pi);
+    return v.at(get(v.size()));
   }
 
   template <typename T>
   T choose(const set<T>& vi) {
-    vector<T> v(vi.size());
-    std::copy(vi.begin(), vi.end(), v.begin());
-    return choose(v);
+    auto it = vi.begin();
+    std::advance(it, get(vi.size()));
+    return *it;
   }
 
   template <typename T>
@@ -394,36 +401,32 @@ class RandomGen {
 
   template <typename T>
   vector<T> permutation(vector<T> v) {
-    random_shuffle(v.begin(), v.end(), [this](int a) { return get(a);});
+    shuffle(v.begin(), v.end());
     return v;
   }
 
   template <typename T>
   vector<T> permutation(const set<T>& vi) {
-    vector<T> v(vi.size());
-    std::copy(vi.begin(), vi.end(), v.begin());
-    return permutation(v);
+    return permutation(vector<T>(vi.begin(), vi.end()));
   }
 
   template <typename T>
   vector<T> permutation(initializer_list<T> vi) {
-    vector<T> v(vi);
-    random_shuffle(v.begin(), v.end(), [this](int a) { return get(a);});
-    return v;
+    return permutation(vector<T>(vi));
   }
 
   vector<int> permutation(Range r) {
     vector<int> v;
     for (int i : r)
       v.push_back(i);
-    random_shuffle(v.begin(), v.end(), [this](int a) { return get(a);});
+    shuffle(v.begin(), v.end());
     return v;
   }
 
   template <typename T>
   vector<T> chooseN(int n, vector<T> v) {
     CHECK(n <= v.size());
-    random_shuffle(v.begin(), v.end(), [this](int a) { return get(a);});
+    shuffle(v.begin(), v.end());
     return getPrefix(v, n);
   }
 
@@ -433,8 +436,18 @@ class RandomGen {
   }
 
   private:
-  default_random_engine generator;
-  std::uniform_real_distribution<double> defaultDist;
+  // xoshiro256** by Blackman and Vigna. The state is filled from the seed using splitmix64.
+  uint64_t next();
+  uint64_t getBounded(uint64_t range);
+  void initState(uint64_t seed);
+  uint64_t state[4] = {1, 2, 3, 4};
+  uint64_t seed = 0;
+
+  template <typename Iter>
+  void shuffle(Iter begin, Iter end) {
+    for (int i = end - begin - 1; i > 0; --i)
+      std::swap(begin[i], begin[get(i + 1)]);
+  }
 
   template <typename T>
   const T& chooseImpl(T const& cur, int total) {
@@ -455,6 +468,13 @@ inline Debug& operator <<(Debug& d, Rectangle rect) {
 }
 
 
+// Tables of numbers and enums are stored as a single block, with the elements in little-endian byte order and runs
+// of equal elements collapsed, which is much smaller and faster than serializing every element separately.
+namespace TableSerialization {
+  string encode(const char* elems, int numElems, int elemSize);
+  void decode(const string&, char* elems, int numElems, int elemSize);
+}
+
 template <class T>
 class Table {
   public:
@@ -557,16 +577,18 @@ class Table {
   template <class Archive> 
   void save(Archive& ar, const unsigned int version) const {
     ar << BOOST_SERIALIZATION_NVP(bounds);
-    for (Vec2 v : bounds)
-      ar << boost::serialization::make_nvp("Elem", (*this)[v]);
+    saveElems(ar, IsPlainValue());
   }
 
   template <class Archive> 
   void load(Archive& ar, const unsigned int version) {
     ar >> BOOST_SERIALIZATION_NVP(bounds);
     mem.reset(new T[bounds.width() * bounds.height()]);
-    for (Vec2 v : bounds)
-      ar >> boost::serialization::make_nvp("Elem", (*this)[v]);
+    // Tables from older saves were stored element by element regardless of the type.
+    if (version == 0)
+      loadElems(ar, std::false_type());
+    else
+      loadElems(ar, IsPlainValue());
   }
 
   BOOST_SERIALIZATION_SPLIT_MEMBER()
@@ -574,10 +596,48 @@ class Table {
   SERIALIZATION_CONSTRUCTOR(Table);
 
   private:
+  typedef std::integral_constant<bool, std::is_arithmetic<T>::value || std::is_enum<T>::value> IsPlainValue;
+
+  template <class Archive> 
+  void saveElems(Archive& ar, std::false_type) const {
+    for (Vec2 v : bounds)
+      ar << boost::serialization::make_nvp("Elem", (*this)[v]);
+  }
+
+  template <class Archive> 
+  void saveElems(Archive& ar, std::true_type) const {
+    string elems = TableSerialization::encode((const char*) mem.get(), bounds.width() * bounds.height(), sizeof(T));
+    ar << BOOST_SERIALIZATION_NVP(elems);
+  }
+
+  template <class Archive> 
+  void loadElems(Archive& ar, std::false_type) {
+    for (Vec2 v : bounds)
+      ar >> boost::serialization::make_nvp("Elem", (*this)[v]);
+  }
+
+  template <class Archive> 
+  void loadElems(Archive& ar, std::true_type) {
+    string elems;
+    ar >> BOOST_SERIALIZATION_NVP(elems);
+    TableSerialization::decode(elems, (char*) mem.get(), bounds.width() * bounds.height(), sizeof(T));
+  }
+
   Rectangle bounds;
   unique_ptr<T[]> mem;
 };
 
+namespace boost {
+namespace serialization {
+template <class T>
+struct version<Table<T>> {
+  typedef mpl::int_<1> type;
+  typedef mpl::integral_c_tag tag;
+  BOOST_STATIC_CONSTANT(int, value = version::type::value);
+};
+}
+}
+
 template<typename T>
 class DirtyTable {
   public:
@@ -1534,6 +1594,10 @@ class AsyncLoop {
   thread t;
 };
 
+// Calls fun(i) for every i in [0, size), splitting the work among threads that take small chunks of indices
+// from a shared counter until none are left. Falls back to a plain loop for small inputs.
+void parallelFor(int size, function<void(int)> fun);
+
 template <typename T, typename... Args>
 function<void(Args...)> bindMethod(void (T::*ptr) (Args...), T* t) {
   return [=](Args... a) { (t->*ptr)(a...);};
@@ -109,6 +109,23 @@ const EnumMap<HighlightType, double>& ViewIndex::getHighlightMap() const {
   return highlight;
 }
 
+bool ViewIndex::operator == (const ViewIndex& o) const {
+  if (anyHighlight != o.anyHighlight || !(highlight == o.highlight) || hiddenId != o.hiddenId)
+    return false;
+  for (ViewLayer l : ENUM_ALL(ViewLayer))
+    if (hasObject(l) != o.hasObject(l) || (hasObject(l) && !(getObject(l) == o.getObject(l))))
+      return false;
+  return true;
+}
+
+int ViewIndex::getHash() const {
+  size_t ret = 0;
+  for (ViewLayer l : ENUM_ALL(ViewLayer))
+    if (hasObject(l))
+      ret = combineHash(ret, getObject(l));
+  return ret;
+}
+
 void ViewIndex::mergeFromMemory(const ViewIndex& memory) {
   if (isEmpty())
     *this = memory;
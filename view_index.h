@@ -60,6 +60,9 @@ class ViewIndex {
   double getHighlight(HighlightType) const;
   const EnumMap<HighlightType, double>& getHighlightMap() const;
 
+  bool operator == (const ViewIndex&) const;
+  int getHash() const;
+
   template <class Archive> 
   void serialize(Archive& ar, const unsigned int version);
 
@@ -20,27 +20,46 @@
 
 template <class Archive> 
 void ViewObject::serialize(Archive& ar, const unsigned int version) {
+  // Shared and packed members are saved in their original form to keep the save format.
+  optional<string> descriptionString;
+  EnumMap<Attribute, optional<float>> attributesMap;
+  if (!Archive::is_loading::value) {
+    if (description)
+      descriptionString = *description;
+    for (Attribute attr : ENUM_ALL(Attribute))
+      attributesMap[attr] = getAttribute(attr);
+  }
   ar& SVAR(resource_id)
     & SVAR(viewLayer)
-    & SVAR(description)
+    & boost::serialization::make_nvp("description", descriptionString)
     & SVAR(modifiers)
-    & SVAR(attributes)
+    & boost::serialization::make_nvp("attributes", attributesMap)
     & SVAR(attachmentDir)
     & SVAR(position)
     & SVAR(creatureId)
     & SVAR(adjectives);
+  if (Archive::is_loading::value) {
+    if (descriptionString)
+      setDescription(*descriptionString);
+    for (Attribute attr : ENUM_ALL(Attribute))
+      attributes[attr] = attributesMap[attr] ? *attributesMap[attr] : NAN;
+  }
 }
 
 SERIALIZABLE(ViewObject);
 
-SERIALIZATION_CONSTRUCTOR_IMPL(ViewObject);
+ViewObject::ViewObject() {
+  attributes.clear(NAN);
+}
 
 ViewObject::ViewObject(ViewId id, ViewLayer l, const string& d)
-    : resource_id(id), viewLayer(l), description(d) {
+    : resource_id(id), viewLayer(l), description(std::make_shared<const string>(d)) {
+  attributes.clear(NAN);
 }
 
 ViewObject::ViewObject(ViewId id, ViewLayer l)
     : resource_id(id), viewLayer(l) {
+  attributes.clear(NAN);
 }
 
 void ViewObject::setCreatureId(UniqueEntity<Creature>::Id id) {
@@ -140,13 +159,37 @@ bool ViewObject::hasModifier(Modifier mod) const {
   return modifiers.contains(mod);
 }
 
+bool ViewObject::operator == (const ViewObject& o) const {
+  if (resource_id != o.resource_id || viewLayer != o.viewLayer || !(modifiers == o.modifiers) ||
+      !descriptionEquals(o) || adjectives != o.adjectives || attachmentDir != o.attachmentDir ||
+      !(position == o.position) || creatureId != o.creatureId || indoors != o.indoors)
+    return false;
+  for (Attribute attr : ENUM_ALL(Attribute))
+    if (getAttribute(attr) != o.getAttribute(attr))
+      return false;
+  return true;
+}
+
+bool ViewObject::descriptionEquals(const ViewObject& o) const {
+  if (description == o.description)
+    return true;
+  return description && o.description && *description == *o.description;
+}
+
+int ViewObject::getHash() const {
+  return combineHash(resource_id, viewLayer, description ? *description : string(), modifiers);
+}
+
 ViewObject& ViewObject::setAttribute(Attribute attr, double d) {
   attributes[attr] = d;
   return *this;
 }
 
 optional<float> ViewObject::getAttribute(Attribute attr) const {
-  return attributes[attr];
+  if (std::isnan(attributes[attr]))
+    return none;
+  else
+    return attributes[attr];
 }
 
 void ViewObject::setIndoors(bool state) {
@@ -154,7 +197,8 @@ void ViewObject::setIndoors(bool state) {
 }
 
 void ViewObject::setDescription(const string& s) {
-  description = s;
+  if (!description || *description != s)
+    description = std::make_shared<const string>(s);
 }
 
 const char* ViewObject::getDefaultDescription() const {
@@ -255,11 +299,11 @@ void ViewObject::setAdjectives(const vector<string>& adj) {
 
 vector<string> ViewObject::getLegend() const {
   vector<string> ret { string(getDescription()) };
-  if (!!attributes[Attribute::LEVEL])
+  if (getAttribute(Attribute::LEVEL))
     ret[0] = ret[0] + ", level " + getAttributeString(Attribute::LEVEL);
-  if (!!attributes[Attribute::EFFICIENCY])
+  if (getAttribute(Attribute::EFFICIENCY))
     ret[0] = ret[0] + ", efficiency " + getAttributeString(Attribute::EFFICIENCY);
-  if (!!attributes[Attribute::ATTACK])
+  if (getAttribute(Attribute::ATTACK))
     ret.push_back("Attack " + getAttributeString(Attribute::ATTACK) +
           " defense " + getAttributeString(Attribute::DEFENSE));
   if (hasModifier(Modifier::PLANNED))
@@ -270,7 +314,7 @@ vector<string> ViewObject::getLegend() const {
     ret.push_back(*indoors ? "Indoors" : "Outdoors");
   if (position.x > -1)
     ret.push_back(toString(position.x) + ", " + toString(position.y));
-  if (!!attributes[Attribute::MORALE])
+  if (getAttribute(Attribute::MORALE))
     ret.push_back("Morale " + getAttributeString(Attribute::MORALE));
   append(ret, adjectives);
   return ret;
@@ -89,6 +89,10 @@ class ViewObject {
   void setCreatureId(UniqueEntity<Creature>::Id);
   optional<UniqueEntity<Creature>::Id> getCreatureId() const;
 
+  // Compares everything but the movement animation state.
+  bool operator == (const ViewObject&) const;
+  int getHash() const;
+
   const static ViewObject& unknownMonster();
   const static ViewObject& empty();
   const static ViewObject& mana();
@@ -98,15 +102,20 @@ class ViewObject {
   private:
   string getAttributeString(Attribute) const;
   const char* getDefaultDescription() const;
+  bool descriptionEquals(const ViewObject&) const;
   enum EnemyStatus { HOSTILE, FRIENDLY, UNKNOWN };
   EnumSet<Modifier> SERIAL(modifiers);
-  EnumMap<Attribute, optional<float>> SERIAL(attributes);
+  // NaN marks a missing attribute.
+  EnumMap<Attribute, float> SERIAL(attributes);
   ViewId SERIAL(resource_id);
   ViewLayer SERIAL(viewLayer);
-  optional<string> SERIAL(description);
+  // Description is shared between copies, so that copying a ViewObject doesn't copy the string.
+  // It's freed together with the last copy. Null means no value.
+  std::shared_ptr<const string> SERIAL(description);
   optional<Dir> SERIAL(attachmentDir);
   Vec2 SERIAL(position) = Vec2(-1, -1);
   optional<UniqueEntity<Creature>::Id> SERIAL(creatureId);
+  // Adjectives contain per-turn text like remaining durations, so they aren't interned. Most objects have none.
   vector<string> SERIAL(adjectives);
   optional<bool> indoors;
 
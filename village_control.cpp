@@ -144,26 +144,28 @@ void VillageControl::considerWelcomeMessage() {
     if (villain->welcomeMessage)
       switch (*villain->welcomeMessage) {
         case DRAGON_WELCOME:
-          for (Position pos : getCollective()->getTerritory().getAll())
-            if (Creature* c = pos.getCreature())
-              if (c->isAffected(LastingEffect::INVISIBLE) && isEnemy(c) && c->isPlayer()
-                  && getCollective()->getLeader()->canSee(c->getPosition())) {
-                c->playerMessage(PlayerMessage("\"Well thief! I smell you and I feel your air. "
-                      "I hear your breath. Come along!\"", MessagePriority::CRITICAL));
-                villain->welcomeMessage.reset();
-              }
+          if (Creature* c = getCollective()->getGame()->getPlayer())
+            if (getCollective()->getTerritory().contains(c->getPosition()) &&
+                c->isAffected(LastingEffect::INVISIBLE) && isEnemy(c)
+                && getCollective()->getLeader()->canSee(c->getPosition())) {
+              c->playerMessage(PlayerMessage("\"Well thief! I smell you and I feel your air. "
+                    "I hear your breath. Come along!\"", MessagePriority::CRITICAL));
+              villain->welcomeMessage.reset();
+            }
           break;
       }
 }
 
 void VillageControl::checkEntries() {
-  if (villain)
-    for (auto& trigger : villain->triggers)
-      if (trigger.getId() == AttackTriggerId::ENTRY)
-        for (Position pos : getCollective()->getTerritory().getAll())
-          if (Creature* c = pos.getCreature())
-            if (getCollective()->getTribe()->isEnemy(c))
-              entries = true;
+  // Once set, the flag is never cleared, so there is nothing more to check.
+  if (!villain || entries || !contains(villain->triggers, AttackTriggerId::ENTRY))
+    return;
+  const Territory& territory = getCollective()->getTerritory();
+  for (Creature* c : getCollective()->getLevel()->getAllCreatures())
+    if (territory.contains(c->getPosition()) && getCollective()->getTribe()->isEnemy(c)) {
+      entries = true;
+      return;
+    }
 }
 
 bool VillageControl::canPerformAttack(bool currentlyActive) {
@@ -177,7 +179,7 @@ void VillageControl::update(bool currentlyActive) {
   checkEntries();
   if (Collective* enemy = getEnemyCollective())
     maxEnemyPower = max(maxEnemyPower, enemy->getDangerLevel());
-  vector<Creature*> allMembers = getCollective()->getCreatures();
+  int numMembers = getCollective()->getCreatures().size();
   for (auto team : getCollective()->getTeams().getAll()) {
     for (const Creature* c : getCollective()->getTeams().getMembers(team))
       if (!getCollective()->hasTask(c)) {
@@ -195,13 +197,13 @@ void VillageControl::update(bool currentlyActive) {
         fighters = getCollective()->getCreatures({MinionTrait::FIGHTER}, {MinionTrait::SUMMONED});
         if (getCollective()->getGame()->isSingleModel())
           fighters = filter(fighters, [this] (const Creature* c) {
-              return contains(getCollective()->getTerritory().getAll(), c->getPosition()); });
+              return getCollective()->getTerritory().contains(c->getPosition()); });
         Debug() << getCollective()->getName().getShort() << " fighters: " << int(fighters.size())
           << (!getCollective()->getTeams().getAll().empty() ? " attacking " : "");
         if (fighters.size() >= villain->minTeamSize && 
-            allMembers.size() >= villain->minPopulation + villain->minTeamSize)
+            numMembers >= villain->minPopulation + villain->minTeamSize)
         launchAttack(getPrefix(Random.permutation(fighters),
-          Random.get(villain->minTeamSize, min(fighters.size(), allMembers.size() - villain->minPopulation) + 1)));
+          Random.get(villain->minTeamSize, min<int>(fighters.size(), numMembers - villain->minPopulation) + 1)));
       }
     }
 }
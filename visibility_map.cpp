@@ -11,11 +11,27 @@ void VisibilityMap::serialize(Archive& ar, const unsigned int version) {
 
 SERIALIZABLE(VisibilityMap);
 
+// Only the tiles that enter or leave the creature's view are touched. The stored tile lists are kept
+// sorted, but saves from before this change may contain unsorted ones.
 void VisibilityMap::update(const Creature* c, vector<Position> visibleTiles) {
-  remove(c);
-  lastUpdates.set(c, visibleTiles);
-  for (Position v : visibleTiles)
-    ++visibilityCount.getOrInit(v);
+  std::sort(visibleTiles.begin(), visibleTiles.end());
+  visibleTiles.erase(std::unique(visibleTiles.begin(), visibleTiles.end()), visibleTiles.end());
+  vector<Position>& previous = lastUpdates.getOrInit(c);
+  if (!std::is_sorted(previous.begin(), previous.end()))
+    std::sort(previous.begin(), previous.end());
+  auto oldIt = previous.begin();
+  auto newIt = visibleTiles.begin();
+  while (oldIt != previous.end() || newIt != visibleTiles.end()) {
+    if (newIt == visibleTiles.end() || (oldIt != previous.end() && *oldIt < *newIt))
+      --visibilityCount.getOrFail(*oldIt++);
+    else if (oldIt == previous.end() || *newIt < *oldIt)
+      ++visibilityCount.getOrInit(*newIt++);
+    else {
+      ++oldIt;
+      ++newIt;
+    }
+  }
+  previous = std::move(visibleTiles);
 }
 
 void VisibilityMap::remove(const Creature* c) {
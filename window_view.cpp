@@ -355,8 +355,8 @@ void WindowView::rebuildGui() {
   int newHash = gameInfo.getHash();
   if (newHash == lastGuiHash)
     return;
-  Debug() << "Rebuilding UI";
   lastGuiHash = newHash;
+  guiBuilder.clearNumRebuiltSections();
   PGuiElem bottom, right;
   vector<GuiBuilder::OverlayInfo> overlays;
   int rightBarWidth = 0;
@@ -454,6 +454,7 @@ void WindowView::rebuildGui() {
       Debug() << "Overlay " << overlay.alignment << " bounds " << tempGuiElems.back()->getBounds();
     }
   }
+  Debug() << "Rebuilt UI, " << guiBuilder.getNumRebuiltSections() << " sections changed";
   Event ev;
   ev.type = SDL_MOUSEMOTION;
   ev.motion.x = renderer.getMousePos().x;